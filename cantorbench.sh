@@ -0,0 +1,11 @@
+#!/bin/bash
+#
+# Compare the linear and the subproduct tree products of Cantor's
+# algorithm, and the construction time of the tower levels.
+#
+# Usage: ./testsuite.sh testsuites/suite-p.tst <threads> cantor
+
+bin=$(dirname $0)/test/testCantor;
+
+echo "p =" $1 "d =" $2 "l =" $3 "threads =" $4
+echo $1 $2 $3 $4 | $bin | tail -n +5
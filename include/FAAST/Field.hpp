@@ -25,55 +25,25 @@
 #include "Exceptions.hpp"
 #include "FieldElement.hpp"
 #include "FieldPolynomial.hpp"
+#include "Threads.hpp"
+#include "Instrumentation.hpp"
 #include <memory>
 
 namespace FAAST {
 
-#ifdef FAAST_TIMINGS
 	/**
-	 * \brief This struct stores various timings related to precomputations.
+	 * \brief Counters of the context switches performed by a thread.
 	 *
-	 * \see [\ref ISSAC "DFS '09"] for details on the computations.
-	 *
-	 * \note The preprocessor flag \c FAAST_TIMINGS has to be passed to the compiler
-	 * in order to activate this feature.
+	 * \see Field::switchContext(), Field::contextSwitches().
 	 */
-	typedef struct TIMINGS {
-		/** \brief The time spent precomputing the (2p-1)-th cyclotomic polynomial */
-		double CYCLOTOMIC;
-		/** \brief The time spent precomputing the pseudotraces. See [\ref ISSAC "DFS '09", Section 5]. */
-		double PSEUDOTRACES;
-		/** \brief The time spent precomputing the inverse of the derivative of the defining polynomial.
-		 * See [\ref ISSAC "DFS '09", Section 4]. */
-		double LIFTUP;
-		/** \brief The time spent precomputing the coefficients of the trace form over the bivariate
-		 * basis. See [\ref ISSAC "DFS '09", Section 4]. */
-		double TRACEVEC;
-		/** \brief The time spent precomputing irreducible polynomials for base fields. */
-		double BUILDIRRED;
-		/** \brief The time spent testing the irreducibility of polynomials defining base fields. */
-		double IRREDTEST;
-		/** \brief The time spent testing primality of cardinalities */
-		double PRIMETEST;
-		/** \brief The time spent precomputing and inverting the matrix of the application
-		 * X<sup>p</sup> - X in base fields. See [\ref ISSAC "DFS '09", Section 6]. */
-		double ARTINMATRIX;
-		/** \brief The time spent computing the primitive tower. See [\ref ISSAC "DFS '09", Section 3]. */
-		double BUILDSTEM;
-
-		TIMINGS() : CYCLOTOMIC(0),
-		PSEUDOTRACES(0),
-		LIFTUP(0),
-		TRACEVEC(0),
-		BUILDIRRED(0),
-		IRREDTEST(0),
-		PRIMETEST(0),
-		ARTINMATRIX(0),
-		BUILDSTEM(0)
-		{}
-	} TIMINGS;
-#endif
+	typedef struct ContextSwitches {
+		/** \brief The number of times \NTL's contexts were actually restored. */
+		unsigned long restored;
+		/** \brief The number of times the restore was skipped, the context being already active. */
+		unsigned long skipped;
 
+		ContextSwitches() : restored(0), skipped(0) {}
+	} ContextSwitches;
 
 	/**
 	 * \defgroup Fields Finite Field Arithmetics
@@ -119,14 +89,8 @@ namespace FAAST {
 	friend class FieldElement<T>;
 	friend void pushDown<T>(const FieldElement<T>& e, vector<FieldElement<T> >& v) throw(NoSubFieldException);
 	friend void liftUp<T>(const vector<FieldElement<T> >& v, FieldElement<T>& e) throw(NotInSameFieldException, NoOverFieldException);
-
-#ifdef FAAST_TIMINGS
-	public:
-		/**
-		 * \brief \copybrief TIMINGS See TIMINGS.
-		 */
-		static TIMINGS TIME;
-#endif
+	friend class PushDownPlan<T>;
+	friend class LiftUpPlan<T>;
 
 	/** \name Local types
 	 * Local types defined in this class. They are aliases to simplify the access
@@ -138,6 +102,17 @@ namespace FAAST {
 	public:
 		/** \brief A link to the \ref Infrastructures Infrastructure. */
 		typedef T Infrastructure;
+		/** \brief How the base case of Couveignes2000() is solved. */
+		enum ArtinSolver {
+			/** \brief Multiply by the inverse of the matrix of
+			 * X<sup>p</sup> - X. */
+			ARTIN_INVERSE,
+			/** \brief Solve with an LU factorization of the matrix of
+			 * X<sup>p</sup> - X. It is about three times cheaper to
+			 * compute than the inverse, and as fast to use. This is the
+			 * default. */
+			ARTIN_LU
+		};
 
 	private:
 		typedef typename T::GFp         GFp;
@@ -149,6 +124,7 @@ namespace FAAST {
 		typedef typename T::BigInt      BigInt;
 		typedef typename T::Context     Context;
 		typedef typename T::GFpXModulus GFpXModulus;
+		typedef typename T::GFpXArgument GFpXArgument;
 	/** @} */
 
 	/** \cond DEV */
@@ -156,32 +132,94 @@ namespace FAAST {
 	/** @{ */
 		/** \brief The immediate subfield, if it is defined */
 		mutable const Field<T>* subfield;
-		/** \brief The immediate overfield, if it is defined */
-		mutable const Field<T>* overfield;
+		/** \brief The immediate overfield, if it is defined.
+		 * It is published only once completely built, see \ref extending.
+		 */
+		mutable const Field<T>* volatile overfield;
 		/** \brief  Infrastructure-dependent data to perform computations in
 		 * the field. (e.g. GF2EContext in NTL)
 		 */
 		Context context;
 		/** \brief  The generator over GF(p) */
 		const auto_ptr<const FieldElement<T> > primitive;
-		/** \brief  Precomputed pseudotraces */
+		/** \brief  Precomputed pseudotraces, the (2<sup>i</sup>p<sup>j</sup>d)-th
+		 * pseudotrace of \ref alpha being at j*NumBits(p) + i
+		 */
 		mutable vector<FieldElement<T> > pseudotraces;
 		/** \brief  Lift-up precomputation */
 		mutable auto_ptr<const FieldElement<T> > liftuphelper;
-		/** \brief  The inverse matrix of the d-1 minor of the
-		 * linear application X<sup>p</sup>-X
+		/** \brief  The d-1 minor of the linear application X<sup>p</sup>-X,
+		 * inverted or factored according to \ref artinSolver
 		 */
 		mutable MatGFp artin;
 		/** \brief  The line we took away from X<sup>p</sup>-X to make
 		 * it invertible
 		 */
 		mutable long artinLine;
+		/** \brief  The row exchanges of the LU factorization of \ref artin */
+		mutable vector<long> artinPivots;
+		/** \brief  How \ref artin is stored */
+		mutable ArtinSolver artinSolver;
+		/** \brief  The tables for composing with X<sup>p<sup>2<sup>i</sup></sup></sup>
+		 * modulo the defining polynomial of a base field
+		 */
+		mutable vector<GFpXArgument> frobeniustable;
 		/** \brief  Flag related to the construction of the extension */
 		const bool plusone;
 		/** \brief \copybrief plusone */
 		const bool twopminusone;
 		/** \brief  The (2 \a p - 1)th cyclotomic polynomial */
 		mutable auto_ptr<const Context> Phi;
+		/** \brief  The modulus used by liftUp() to lift up from this field,
+		 * shifted if the overfield is built with plusone, together
+		 * with its trace vector
+		 */
+		mutable auto_ptr<const GFpXModulus> liftupmodulus;
+		/** \brief  The trace form of \ref liftupmodulus */
+		mutable GFpX traceform;
+		/** \brief  The factorials of 0, ..., \a p - 1, in prime fields */
+		mutable VecGFp factorials;
+		/** \brief  The inverses of \ref factorials */
+		mutable VecGFp invfactorials;
+		/** \brief  The series z/(e<sup>z</sup> - 1), truncated at z<sup>p-1</sup>,
+		 * in prime fields. Its coefficients are the Bernoulli numbers divided by
+		 * their factorials.
+		 */
+		mutable GFpX bernoulli;
+		/** \brief  In fields that are not on the stem, the push-downs of
+		 * 1, \ref gen, ..., \ref gen<sup>p-1</sup>, \a p coefficients each
+		 */
+		mutable vector<FieldElement<T> > genpushdowns;
+		/** \brief  The number of rows of pseudotraces that have been published */
+		mutable volatile long pseudotracecount;
+		/** \brief  The precomputations that have been published, as
+		 * a combination of Precomputation flags
+		 */
+		mutable volatile unsigned int ready;
+		/** \brief  The context installed by the calling thread */
+		struct ContextState {
+			/** \brief  The stem whose context has been restored last */
+			const Field<T>* stem;
+			/** \brief  The address of \NTL's modulus right after
+			 * the restore, to detect later changes
+			 */
+			const void* modulus;
+			/** \brief \copybrief ContextSwitches */
+			ContextSwitches switches;
+			ContextState() : stem(NULL), modulus(NULL) {}
+		};
+		/** \brief  Per-thread \copybrief ContextState */
+		static ThreadLocal<ContextState> current;
+		/** \brief  Protects the on-demand precomputations above
+		 * against concurrent threads. It is recursive, as computing
+		 * a precomputation may need another one of the same field.
+		 */
+		mutable Mutex lock;
+		/** \brief  Serializes the construction of \ref overfield :
+		 * threads asking for an extension while it is being built
+		 * wait here, then find it published.
+		 */
+		mutable Mutex extending;
 	/** @} */
 
 	/****************//** \name Data members for non-stem fields ******************/
@@ -319,6 +357,10 @@ namespace FAAST {
 		 * \brief Build a primitive extension of degree \a p
 		 * as in [\ref ISSAC "DFS '09", Section 3].
 		 *
+		 * The extension is built only once: later calls return the same
+		 * object. This method can be called concurrently by several threads,
+		 * only one of them builds the extension while the others wait for it.
+		 *
 		 * \return A reference to the newly created Field object.
 		 *
 		 * \throws CharacteristicTooLargeException If \ref p is a multiprecision
@@ -370,6 +412,84 @@ namespace FAAST {
 		const throw(IllegalCoercionException, IsIrreducibleException);
 	/** @} */
 
+	/****************//** \name Precomputations ******************/
+	/** @{ */
+		/** \brief The precomputations that can be requested from precompute(). */
+		enum Precomputation {
+			/** \brief The pseudotraces used to compute Frobenius maps. */
+			PSEUDOTRACES = 1,
+			/** \brief The data used by liftUp(): the inverse of the derivative of
+			 * the defining polynomials and the trace forms. */
+			LIFTUP = 2,
+			/** \brief The factorization or inverse of the matrix of
+			 * X<sup>p</sup> - X in the base field, see setArtinSolver(),
+			 * used by Couveignes2000(). */
+			ARTIN = 4,
+			/** \brief The (2\a p - 1)-th cyclotomic polynomial, used by
+			 * ArtinSchreierExtension(). */
+			CYCLOTOMIC = 8,
+			/** \brief The tables of the iterated Frobenius in base fields, used
+			 * by FieldElement::frobenius(const long) const and
+			 * FieldElement::pseudotrace(). */
+			FROBENIUS = 16,
+			/** \brief The factorials and the Bernoulli numbers modulo \a p,
+			 * used by Couveignes2000(). */
+			BINOMIALS = 32,
+			/** \brief The change of basis of fields that are not on the stem,
+			 * used by toBivariate() and toUnivariate(). */
+			ISOMORPHISM = 64,
+			/** \brief All of the above. */
+			ALL = 127
+		};
+		/**
+		 * \brief Do the precomputations of this field and of its subfields.
+		 *
+		 * Precomputations are normally done on demand, the first time they are
+		 * needed, which can make the first operations in a new field much slower
+		 * than the following ones. This method does them in advance, in parallel
+		 * when getThreads() is greater than one.
+		 *
+		 * \param [in] mask A combination of Precomputation flags.
+		 */
+		void precompute(const unsigned int mask = ALL) const;
+		/**
+		 * \brief Choose the solver used in the base field of this field.
+		 *
+		 * If the matrix has already been computed with another solver, it is
+		 * computed again: do not call this method while other threads solve
+		 * Artin-Schreier equations in the same tower.
+		 */
+		void setArtinSolver(const ArtinSolver s) const;
+		/** \brief The solver used in the base field of this field. */
+		ArtinSolver getArtinSolver() const throw() {
+			return baseField().artinSolver;
+		}
+		/**
+		 * \brief Write the matrix of X<sup>p</sup> - X of the base field to \a o.
+		 *
+		 * The matrix is computed if needed and is written along with the
+		 * defining polynomial of the base field. It can be read back with
+		 * loadArtinMatrix(), in a later run, to avoid computing it again.
+		 *
+		 * \throws BadParametersException If the base field is a prime field.
+		 */
+		void saveArtinMatrix(ostream& o) const throw(BadParametersException);
+		/**
+		 * \brief Read the matrix of X<sup>p</sup> - X of the base field from \a i.
+		 *
+		 * The data must have been written by saveArtinMatrix() for a base field
+		 * with the same defining polynomial. The solver of the base field becomes
+		 * the one of the saved matrix. The matrix must not have been computed
+		 * yet: do not call this method while other threads solve Artin-Schreier
+		 * equations in the same tower.
+		 *
+		 * \throws BadParametersException If the data do not fit the base field
+		 * or were written for another defining polynomial, if the matrix is
+		 * already there, or if the base field is a prime field.
+		 */
+		void loadArtinMatrix(istream& i) const throw(BadParametersException);
+	/** @} */
+
 	/****************//** \name Properties ******************/
 	/** @{ */
 		/**
@@ -474,11 +594,34 @@ namespace FAAST {
 		 * of the library and then transform the result to a FieldElement or
 		 * FieldPolynomial through a call to a fromInfrastructure() method.
 		 *
+		 * Each thread remembers which context it has installed last: if it is
+		 * still active the restore is skipped. \NTL's moduli are compared by
+		 * address, so that changing them outside of this library (e.g. through
+		 * \c T::GFpE::init()) is always detected.
+		 *
 		 * \warning Be aware that the current context is undefined after any
 		 * call to a function of this library.
-		 * \see \link using_infrastructure.c++ using_infrastructure.c++ \endlink
+		 * \see \link using_infrastructure.c++ using_infrastructure.c++ \endlink,
+		 * FieldScope, contextSwitches().
 		 */
 		void switchContext() const throw();
+		/**
+		 * \brief The stem field whose context has been installed last by the
+		 * calling thread.
+		 *
+		 * \return A pointer to the stem field, or \c NULL if the thread has
+		 * never installed a context.
+		 */
+		static const Field<T>* activeField() throw() { return current.get().stem; }
+		/**
+		 * \brief The context switches performed and skipped by the calling thread.
+		 *
+		 * \see switchContext(), resetContextSwitches().
+		 */
+		static ContextSwitches contextSwitches() throw() { return current.get().switches; }
+		/** \brief Reset the counters returned by contextSwitches(). */
+		static void resetContextSwitches() throw()
+		{ current.get().switches = ContextSwitches(); }
 		/**
 		 * \brief Build an element of this field from an \NTL type.
 		 *
@@ -638,6 +781,8 @@ namespace FAAST {
 		 * \invariant When \a e belongs to a field in the primitive tower (the stem),
 		 * this is equivalent to
 		 * \link FieldElement::pushDown() \c pushDown(e, v) \endlink and then coerce all the contents of \a v to this field.
+		 * Otherwise, the first call pushes down the powers of \a x once and for all
+		 * (see \ref ISOMORPHISM).
 		 * \see pushDown().
 		 */
 		void toBivariate(const FieldElement<T>& e, vector<FieldElement<T> >& v) const
@@ -677,6 +822,7 @@ namespace FAAST {
 		 * \invariant When this field is in the primitive tower (the stem), this is equivalent to
 		 * coerce all the contents of \a v to the stem and then
 		 * \link FieldElement::liftUp() \c liftUp(v, e) \endlink.
+		 * Otherwise, it costs one liftUp() after the same precomputation as toBivariate().
 		 * \see liftUp().
 		 */
 		void toUnivariate(const vector<FieldElement<T> >& v, FieldElement<T>& e) const
@@ -740,13 +886,30 @@ namespace FAAST {
 	private:
 	/****************//** \name Access to precomputed values
 	 * These methods grant acces to precomputed values. They compute the values
-	 * on-demand when called the first time.
+	 * on-demand when called the first time, holding the lock of the stem, and
+	 * publish them in \ref ready; later calls do not take the lock.
 	 * @{ */
-		const FieldElement<T>& getPseudotrace(const long i) const;
+		const FieldElement<T>& getPseudotrace(const long j, const long i = 0) const;
 		const FieldElement<T>& getLiftup() const;
 		const MatGFp& getArtinMatrix() const;
+		void solveArtin(VecGFp& x, const VecGFp& b) const;
 		const Context& getCyclotomic() const;
+		const GFpXModulus& getLiftupModulus() const;
+		const GFpX& getTraceForm() const;
+		const vector<GFpXArgument>& getFrobeniusTable() const;
+		const VecGFp& getFactorials() const;
+		const VecGFp& getInvFactorials() const;
+		const GFpX& getBernoulli() const;
+		const vector<FieldElement<T> >& getGenPushDowns() const;
 	/** @} */
+		/** \brief Flag of \ref ready for the lift-up modulus and trace form */
+		enum { TRACEFORM = 128 };
+		/** \brief Whether \a n iterated Frobenius in this field are cheaper
+		 * as compositions with the \ref frobeniustable than as powerings.
+		 */
+		bool useFrobeniusTable(const long n) const;
+		/** \brief Runs one of the precomputations in a TaskGroup. */
+		class PrecomputeTask;
 
 	/****************** Copy prohibited ******************/
 		void operator=(const Field<T>&);
@@ -790,13 +953,19 @@ namespace FAAST {
 		primitive(pri),
 		pseudotraces(pseudo),
 		liftuphelper(liftup),
-		artin(mat), artinLine(line),
+		artin(mat), artinLine(line), artinPivots(), artinSolver(ARTIN_INVERSE),
+		frobeniustable(),
 		plusone(pluso), twopminusone(twopminuso),
-		Phi(Ph),
+		Phi(Ph), liftupmodulus(), traceform(),
+		factorials(), invfactorials(), bernoulli(),
+		genpushdowns(),
+		pseudotracecount(pseudo.size() / NumBits(cha)),
+		ready((liftup ? LIFTUP : 0) | (line >= 0 ? ARTIN : 0) | (Ph ? CYCLOTOMIC : 0)),
+		lock(true),
 		stem(st), vsubfield(vsub),
 		gen(g), alpha(a),
 		p(cha), d(deg), height(h)
-		{}
+		{ pseudotraces.reserve(h * NumBits(p)); }
 		/** \brief Construct a base fields */
 		Field<T> (
 			const Field<T>* sub,
@@ -811,9 +980,14 @@ namespace FAAST {
 		primitive(new FieldElement<T>(this, pri)),
 		pseudotraces(),
 		liftuphelper(),
-		artin(), artinLine(-1),
+		artin(), artinLine(-1), artinPivots(), artinSolver(ARTIN_LU),
+		frobeniustable(),
 		plusone(false), twopminusone(false),
-		Phi(),
+		Phi(), liftupmodulus(), traceform(),
+		factorials(), invfactorials(), bernoulli(),
+		genpushdowns(),
+		pseudotracecount(0), ready(0),
+		lock(true),
 		stem(this), vsubfield(NULL),
 		gen(new FieldElement<T>(this, g)),
 		alpha(),
@@ -830,9 +1004,14 @@ namespace FAAST {
 		primitive(new FieldElement<T>(this, pri)),
 		pseudotraces(),
 		liftuphelper(),
-		artin(), artinLine(-1),
+		artin(), artinLine(-1), artinPivots(), artinSolver(ARTIN_LU),
+		frobeniustable(),
 		plusone(false), twopminusone(false),
-		Phi(),
+		Phi(), liftupmodulus(), traceform(),
+		factorials(), invfactorials(), bernoulli(),
+		genpushdowns(),
+		pseudotracecount(0), ready(0),
+		lock(true),
 		stem(this), vsubfield(NULL),
 		gen(new FieldElement<T>(this, pri)),
 		alpha(),
@@ -856,14 +1035,19 @@ namespace FAAST {
 		primitive(new FieldElement<T>(this, pri)),
 		pseudotraces(),
 		liftuphelper(),
-		artin(), artinLine(-1),
+		artin(), artinLine(-1), artinPivots(), artinSolver(ARTIN_LU),
+		frobeniustable(),
 		plusone(po), twopminusone(tpmo),
-		Phi(),
+		Phi(), liftupmodulus(), traceform(),
+		factorials(), invfactorials(), bernoulli(),
+		genpushdowns(),
+		pseudotracecount(0), ready(0),
+		lock(true),
 		stem(this), vsubfield(vsub),
 		gen(new FieldElement<T>(this, pri)),
 		alpha(aleph),
 		p(cha), d(deg), height(h)
-		{}
+		{ pseudotraces.reserve(h * NumBits(p)); }
 		/** \brief Construct a generic field (not on the stem) */
 		Field<T> (
 			const Field<T>* st,
@@ -876,11 +1060,16 @@ namespace FAAST {
 		primitive(NULL),
 		pseudotraces(),
 		liftuphelper(),
-		artin(), artinLine(-1),
+		artin(), artinLine(-1), artinPivots(), artinSolver(ARTIN_LU),
+		frobeniustable(),
 		plusone(), twopminusone(),
-		Phi(),
+		Phi(), liftupmodulus(), traceform(),
+		factorials(), invfactorials(), bernoulli(),
+		genpushdowns(),
+		pseudotracecount(0), ready(0),
+		lock(true),
 		stem(st), vsubfield(vsub),
-		gen(new FieldElement<T>(this, gen.repBase, gen.repExt, gen.base)),
+		gen(new FieldElement<T>(this, gen)),
 		alpha(aleph),
 		p(st->p), d(st->d), height(st->height)
 		{}
@@ -888,6 +1077,37 @@ namespace FAAST {
 	/** \endcond */
 	};
 
+	/**
+	 * \ingroup Fields
+	 * \brief Keep the context of a field active in a block.
+	 *
+	 * Installs the context of a field when constructed, and reinstalls the
+	 * context that was active before when destroyed. Operations on elements
+	 * of the field performed in the block do not need to restore
+	 * \NTL's context. Scopes can be nested.
+	 * \code
+	 * {
+	 * 	FieldScope<T> scope(K);
+	 * 	for (long i = 0 ; i < n ; i++) a *= b;
+	 * }
+	 * \endcode
+	 *
+	 * \see Field::switchContext().
+	 */
+	template <class T> class FieldScope {
+	private:
+		const Field<T>* previous;
+		/* Copy prohibited */
+		FieldScope(const FieldScope<T>&);
+		void operator=(const FieldScope<T>&);
+	public:
+		/** \brief Install the context of \a K. */
+		explicit FieldScope(const Field<T>& K) throw()
+		: previous(Field<T>::activeField()) { K.switchContext(); }
+		/** \brief Reinstall the previously active context, if any. */
+		~FieldScope() throw() { if (previous) previous->switchContext(); }
+	};
+
 	/****************** Printing ******************/
 	/** \brief Print details about \a F to \a o
 	 * \relates Field
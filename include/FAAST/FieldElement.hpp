@@ -25,6 +25,7 @@
 #include "Exceptions.hpp"
 #include <string>
 #include <vector>
+#include <new>
 
 namespace FAAST {
 	template <class T> class Field;
@@ -41,6 +42,24 @@ namespace FAAST {
 	void liftUp(const vector<FieldElement<T> >& v, FieldElement<T>& e)
 	throw(NotInSameFieldException, NoOverFieldException);
 
+	template <class T>
+	void pushDownBatch(const Field<T>& K, const FieldElement<T>* e,
+	const long n, FieldElement<T>* v)
+	throw(NoSubFieldException, NotInSameFieldException);
+
+	template <class T>
+	void liftUpBatch(const Field<T>& K, const FieldElement<T>* v,
+	const long n, FieldElement<T>* e)
+	throw(NotInSameFieldException, NoOverFieldException);
+
+/****************** Batch inversion ******************/
+	template <class T>
+	void invertBatch(FieldElement<T>* e, const long n, vector<long>& zeros)
+	throw(NotInSameFieldException);
+
+	template <class T> class PushDownPlan;
+	template <class T> class LiftUpPlan;
+
 
 /****************** Class FieldElement ******************/
 	/**
@@ -169,6 +188,81 @@ namespace FAAST {
 	 * \relates FieldElement
 	 */
 	friend void liftUp<T>(const vector<FieldElement<T> >& v, FieldElement<T>& e) throw(NotInSameFieldException, NoOverFieldException);
+	/**
+	 * \brief Push down \a n elements of the same field at once.
+	 *
+	 * This is equivalent to calling pushDown() on each of
+	 * \a e[0], ..., \a e[n-1], but the setup that only depends on
+	 * the field is done once and no memory is allocated for the results.
+	 * Let \a w be the degree of \a K over
+	 * \link Field::subField() \c K\c.subField() \endlink (that is \ref Field::p "p",
+	 * or \ref Field::d "d" if \a K is the base field): the coefficients of \a e[i] are
+	 * written to \a v[i*w], ..., \a v[i*w + w - 1], padded with zeros.
+	 *
+	 * When getThreads() is greater than one, the batch is split among the threads.
+	 *
+	 * \param [in] K The field of the elements of \a e.
+	 * \param [in] e An array of \a n elements of \a K, or of any field isomorphic to \a K.
+	 * \param [in] n The number of elements to push down.
+	 * \param [out] v An array of at least <i>n</i> \a w elements.
+	 * \throw NoSubFieldException If \a K is F<sub>p</sub>.
+	 * \throw NotInSameFieldException If an element of \a e does not belong to a field
+	 * isomorphic to \a K.
+	 * \see pushDown().
+	 *
+	 * \relates FieldElement
+	 */
+	friend void pushDownBatch<T>(const Field<T>& K, const FieldElement<T>* e,
+	const long n, FieldElement<T>* v)
+	throw(NoSubFieldException, NotInSameFieldException);
+	/**
+	 * \brief Lift up \a n elements at once.
+	 *
+	 * This is the inverse of pushDownBatch(): with \a w the degree of
+	 * \link Field::overField() \c K\c.overField() \endlink over \a K,
+	 * \a e[i] receives the lift-up of \a v[i*w], ..., \a v[i*w + w - 1]. It is equivalent
+	 * to calling liftUp() on each group of coefficients, but the setup that only
+	 * depends on the field (modulus, trace form, etc.) is done once.
+	 *
+	 * When getThreads() is greater than one, the batch is split among the threads.
+	 *
+	 * \param [in] K The field of the elements of \a v.
+	 * \param [in] v An array of <i>n</i> \a w elements of \a K, or of any field isomorphic to \a K.
+	 * \param [in] n The number of elements to lift up.
+	 * \param [out] e An array of at least \a n elements.
+	 * \throw NotInSameFieldException If an element of \a v does not belong to a field
+	 * isomorphic to \a K.
+	 * \throw NoOverFieldException If \a K has no
+	 * \link Field::overField() overfield\endlink.
+	 * \see liftUp().
+	 *
+	 * \relates FieldElement
+	 */
+	friend void liftUpBatch<T>(const Field<T>& K, const FieldElement<T>* v,
+	const long n, FieldElement<T>* e)
+	throw(NotInSameFieldException, NoOverFieldException);
+	/**
+	 * \brief Invert \a n elements at once.
+	 *
+	 * This is Montgomery's simultaneous inversion: the nonzero elements of \a e are
+	 * inverted in place with one call to self_inv() and <i>3(n-1)</i> multiplications.
+	 * Zero elements are left untouched and their indices are reported in \a zeros,
+	 * instead of throwing a DivisionByZeroException.
+	 *
+	 * \param [in,out] e An array of \a n elements having the same \parent, or being 0.
+	 * \param [in] n The number of elements to invert.
+	 * \param [out] zeros The indices of the elements of \a e equal to 0, in increasing
+	 * order. All previous data are discarded.
+	 * \throw NotInSameFieldException If two nonzero elements of \a e have different
+	 * \link parent() parent fields\endlink.
+	 * \see invertBatch(FieldPolynomial<T>&, vector<long>&).
+	 *
+	 * \relates FieldElement
+	 */
+	friend void invertBatch<T>(FieldElement<T>* e, const long n, vector<long>& zeros)
+	throw(NotInSameFieldException);
+	friend class PushDownPlan<T>;
+	friend class LiftUpPlan<T>;
 
 	/** \name Local types
 	 * Local types defined in this class. They are aliases to simplify the access
@@ -179,6 +273,31 @@ namespace FAAST {
 	 */
 	public:
 		typedef T Infrastructure;
+		/** \brief How minimalPolynomial(const Field<T>&, MinimalPolynomialMethod) const
+		 * computes its result. */
+		enum MinimalPolynomialMethod {
+			/** \brief Choose the cheapest method according to the degrees
+			 * of the fields involved. This is the default. */
+			MINPOL_AUTO,
+			/** \brief Multiply the Galois conjugates level by level, as
+			 * minimalPolynomials() does. */
+			MINPOL_CONJUGATES,
+			/** \brief Project the powers of the element by a random linear
+			 * form and use Berlekamp-Massey on the sequence. */
+			MINPOL_PROJECTION
+		};
+		/** \brief How self_inv() computes its result. */
+		enum InversionMethod {
+			/** \brief Use the Itoh-Tsujii inversion in fields of degree
+			 * at least Constants::ItohTsujii_CROSSOVER, the extended GCD
+			 * otherwise. This is the default. */
+			INV_AUTO,
+			/** \brief The extended GCD of \NTL. */
+			INV_XGCD,
+			/** \brief Divide by the norm to F<sub>p</sub>, computed by a chain
+			 * of frobenius. */
+			INV_ITOH_TSUJII
+		};
 
 	private:
 		typedef typename T::GFp     GFp;
@@ -192,14 +311,58 @@ namespace FAAST {
 
 	/****************** Members ******************/
 	/** \cond DEV */
-		/** \brief The \NTL representation of this element if the \parent is a prime field. */
-		GFp repBase;
-		/** \brief The \NTL representation of this element if the \parent is an extension field. */
-		GFpE repExt;
+		/** \brief The \NTL representation of this element, a GFp if the \parent
+		 * is a prime field, a GFpE otherwise. Only the one selected by \a base is
+		 * alive, see repBase() and repExt(). */
+		union {
+			char baseStorage[sizeof(GFp)];
+			char extStorage[sizeof(GFpE)];
+			void* alignPointer;
+			long alignLong;
+			double alignDouble;
+		} storage;
 		/** \brief Whether this element belongs to a prime or an extension field. */
 		bool base;
 		/** \brief The \parent. NULL if no \parent. */
 		const Field<T>* parent_field;
+
+		/** \brief The \NTL representation of this element if \a base is set. */
+		GFp& repBase() throw() {
+			return *reinterpret_cast<GFp*>(storage.baseStorage);
+		}
+		/** \brief \copybrief repBase() */
+		const GFp& repBase() const throw() {
+			return *reinterpret_cast<const GFp*>(storage.baseStorage);
+		}
+		/** \brief The \NTL representation of this element if \a base is not set. */
+		GFpE& repExt() throw() {
+			return *reinterpret_cast<GFpE*>(storage.extStorage);
+		}
+		/** \brief \copybrief repExt() */
+		const GFpE& repExt() const throw() {
+			return *reinterpret_cast<const GFpE*>(storage.extStorage);
+		}
+		/** \brief Construct the representation selected by \a base, equal to 0. */
+		void constructRep() throw() {
+			if (base) new (storage.baseStorage) GFp();
+			else new (storage.extStorage) GFpE();
+		}
+		/** \brief Destroy the representation selected by \a base. */
+		void destroyRep() throw() {
+			if (base) repBase().~GFp();
+			else repExt().~GFpE();
+		}
+		/** \brief Select the GFp representation if \a b is set, the GFpE one otherwise.
+		 *
+		 * If the selection changes, the old representation is destroyed and the new
+		 * one is 0.
+		 */
+		void setBase(const bool b) throw() {
+			if (b == base) return;
+			destroyRep();
+			base = b;
+			constructRep();
+		}
 	/** \endcond */
 
 	public:
@@ -214,7 +377,7 @@ namespace FAAST {
 		 *
 		 * \see UndefinedFieldException, Field::zero().
 		 */
-		FieldElement() throw() : parent_field(NULL) {}
+		FieldElement() throw() : base(true), parent_field(NULL) { constructRep(); }
 	/** @} */
 	/****************//** \name Properties ******************/
 	/** @{ */
@@ -327,10 +490,14 @@ namespace FAAST {
 			tmp.negate();
 			return tmp;
 		}
-		/** \brief Multiplicative inverse. */
-		FieldElement<T> inv() const throw(DivisionByZeroException) {
+		/** \brief Multiplicative inverse.
+		 *
+		 * \param [in] method The algorithm to use, see self_inv().
+		 */
+		FieldElement<T> inv(const InversionMethod method = INV_AUTO)
+		const throw(DivisionByZeroException) {
 			FieldElement<T> tmp = *this;
-			tmp.self_inv();
+			tmp.self_inv(method);
 			return tmp;
 		}
 		/** \brief Power. */
@@ -399,9 +566,27 @@ namespace FAAST {
 		 */
 		/** \brief Flip the sign of this element. */
 	 	void negate() throw();
-	 	/** \brief Invert this element. */
-		void self_inv() throw(DivisionByZeroException);
-		/** \brief \copybrief operator^() */
+	 	/** \brief Invert this element.
+	 	 *
+	 	 * Besides the extended GCD over the modulus of the \parent, this element
+	 	 * can be inverted in the style of Itoh and Tsujii: with \a D the degree
+	 	 * of the \parent, the power <i>x<sup>r-1</sup></i>, where
+	 	 * <i>r = (p<sup>D</sup>-1)/(p-1)</i>, is computed by about <i>2 log D</i>
+	 	 * frobenius and products; then <i>x<sup>r</sup></i> is the norm of
+	 	 * \a x to F<sub>p</sub>, which is inverted in F<sub>p</sub>. This pays off
+	 	 * where the frobenius is cheap compared to the extended GCD.
+	 	 *
+	 	 * \param [in] method The algorithm to use. Elements of prime fields always
+	 	 * use the extended GCD.
+	 	 */
+		void self_inv(const InversionMethod method = INV_AUTO) throw(DivisionByZeroException);
+		/** \brief \copybrief operator^()
+		 *
+		 * When the base-<i>p</i> digits of the exponent are sparse or periodic, as in
+		 * <i>(p<sup>n</sup>-1)/(p<sup>m</sup>-1)</i>, the power is computed with
+		 * a few frobenius, which are cheap in Artin-Schreier towers, instead of
+		 * square-and-multiply. The algorithm is chosen by a rough cost model.
+		 */
 		void operator^=(const ZZ&) throw();
 		/** \brief \copybrief operator^() */
 		void operator^=(const long) throw();
@@ -426,28 +611,39 @@ namespace FAAST {
 		FieldPolynomial<T> minimalPolynomial() const throw() {
 			parent_field->switchContext();
 			GFpX minpol;
-			MinPolyMod(minpol, rep(repExt), GFpE::modulus());
+			if (base) {
+				SetX(minpol);
+				minpol -= repBase();
+			} else MinPolyMod(minpol, rep(repExt()), GFpE::modulus());
 			return parent_field->primeField().fromInfrastructure(minpol);
 		}
 		/**
 		 * \brief The minimal polynomial over the field \a F.
 		 *
-		 * This method implements a yet unpublished algorithm to compute minimal polynomials
-		 * in Artin-Schreier towers. It only works when \a F is a field of an Artin-Schreier
+		 * This method implements two algorithms to compute minimal polynomials
+		 * in Artin-Schreier towers. They only work when \a F is a field of an Artin-Schreier
 		 * tower as constructed in [\ref ISSAC "DFS '09", Section 3].
 		 *
+		 * The first one, also used by minimalPolynomials(), is a yet unpublished algorithm
+		 * multiplying the Galois conjugates of this element level by level. The second one
+		 * computes <i>2m</i> values of the sequence
+		 * <i>Tr(r x<sup>i</sup>)</i>, where \a m is the degree of the result, \a x this element,
+		 * \a r a random element and \a Tr the trace down to \a F, using
+		 * about <i>2(2m)<sup>1/2</sup></i> products by baby steps-giant steps and pushing down
+		 * the factors to \a F. The minimal polynomial is then recovered by the Berlekamp-Massey
+		 * algorithm through HalfGCD(). The projection pays off when \a x lives few levels above
+		 * \a F in a high tower; by default the method is chosen by comparing the rough costs of both.
+		 *
 		 * \param [in] F A subfield of the \parent of this element.
+		 * \param [in] method The algorithm to use.
 		 * \return A polynomial over \a F being the minimal polynomial of this element.
 		 * \throws NotASubFieldException If the \parent is not an extension field of \a F.
 		 * \throws NotSupportedException If \a F is a prime field not being the base field of an Artin-Schreier
 		 * tower. Use minimalPolynomial() instead.
 		 */
-		FieldPolynomial<T> minimalPolynomial(const Field<T>& F)
-		const throw(NotASubFieldException, NotSupportedException) {
-			vector<FieldPolynomial<T> > minpols;
-			minimalPolynomials(F, minpols);
-			return minpols[0];
-		}
+		FieldPolynomial<T> minimalPolynomial(const Field<T>& F,
+		const MinimalPolynomialMethod method = MINPOL_AUTO)
+		const throw(NotASubFieldException, NotSupportedException);
 		/**
 		 * \brief All the minimal polynomials up to the field \a F.
 		 *
@@ -670,12 +866,12 @@ namespace FAAST {
 		/** \brief Test to zero. */
 		bool isZero() const throw() {
 			return !parent_field ||
-				(base ? IsZero(repBase) : IsZero(repExt));
+				(base ? IsZero(repBase()) : IsZero(repExt()));
 		}
 		/** \brief Test to one. */
 		bool isOne() const throw() {
 			return parent_field &&
-				(base ? IsOne(repBase) : IsOne(repExt));
+				(base ? IsOne(repBase()) : IsOne(repExt()));
 		}
 		/** \brief Test if this element belongs to F<sub>p</sub>.
 		 * \see toScalar().
@@ -744,7 +940,7 @@ namespace FAAST {
 		ostream& print(ostream& o, const vector<string>& vars) const;
 	/** @} */
 	/****************** Destructor ******************/
-		~FieldElement() throw() {}
+		~FieldElement() throw() { destroyRep(); }
 
 
 	/*****************************************************/
@@ -755,15 +951,31 @@ namespace FAAST {
 	/** \cond DEV */
 	/****************//** \name Helpers for frobenius and trace ******************/
 	/** @{ */
-		/** \brief <i>p<sup>j</sup>d</i>-th iterated frobenius.
+		/** \brief <i>2<sup>i</sup>p<sup>j</sup>d</i>-th iterated frobenius, for
+		 * 2<sup>i</sup> <= \a p.
 		 *
-		 * This is the algorithm \c IterFrobenius of [\ref ISSAC "DFS '09"].
+		 * This is the algorithm \c IterFrobenius of [\ref ISSAC "DFS '09"],
+		 * shifting by the <i>2<sup>i</sup>p<sup>j</sup>d</i>-th pseudotrace
+		 * instead of the <i>p<sup>j</sup>d</i>-th one.
 		 */
-		void BigFrob(const long j);
+		void BigFrob(const long j, const long i = 0);
+		/** \brief <i>cp<sup>j</sup>d</i>-th iterated frobenius, for \a c < \a p.
+		 *
+		 * One BigFrob() per bit of \a c.
+		 */
+		void BigFrobPow(const long j, const long c);
+		/** \brief Sum of the first \a c conjugates under the <i>p<sup>j</sup>d</i>-th
+		 * iterated frobenius, for \a c <= \a p.
+		 *
+		 * The number of conjugates is doubled with each BigFrob(), in the
+		 * style of von zur Gathen and Shoup.
+		 */
+		void BigPTraceStep(const long j, const long c);
 		/** \brief <i>n</i>-th iterated frobenius, for \a n < \a d.
 		 *
-		 * This implements a naive algorithm for iterated frobenius.
-		 * \todo Implement a faster algorithm using modular composition.
+		 * In base fields of large enough degree, this composes with the
+		 * Frobenius tables of the field, otherwise it iterates the
+		 * <i>p</i>-th power.
 		 */
 		void SmallFrob(const long n);
 		/** \brief <i>p<sup>j</sup>d</i>-th pseudotrace.
@@ -779,10 +991,47 @@ namespace FAAST {
 		void BigPTraceVector(vector<FieldElement<T> >& v, const long j) const;
 		/** \brief <i>n</i>-th pseudotrace, for \a n < \a d.
 		 *
-		 * This implements a naive algorithm for pseudotrace.
-		 * \todo Implement a faster algorithm using modular composition.
+		 * In base fields of large enough degree, this doubles the number
+		 * of summed conjugates with each composition, otherwise it sums
+		 * the iterated <i>p</i>-th powers.
 		 */
 		void SmallPTrace(const long n);
+		/** \brief Runs BigFrob() on an element of a TaskGroup. */
+		class BigFrobTask;
+	/** @} */
+	/****************//** \name Helpers for exponentiation ******************/
+	/** @{ */
+		/** \brief Rough cost of self_frobenius(long), in multiplications. */
+		double FrobCost(long n) const;
+		/** \brief Rough cost of HornerFrob(), in multiplications. */
+		double HornerFrobCost(const long* dig, const long len) const;
+		/** \brief Power to the exponent of base-<i>p</i> digits \a dig[0], ..., \a dig[\a len - 1].
+		 *
+		 * Horner's rule on the digits, the lowest first, with one
+		 * frobenius per run of zeros. \a powers[i] is this element to the
+		 * \a digits[i], for the sorted nonzero \a digits.
+		 */
+		void HornerFrob(const long* dig, const long len, const vector<long>& digits,
+			const vector<FieldElement<T> >& powers);
+		/** \brief Power to \a e using the frobenius.
+		 *
+		 * The base-<i>p</i> digits of \a e are split into a block repeated
+		 * as many times as possible, the repetitions being done by doubling
+		 * with the frobenius as in Itoh-Tsujii. Nothing is done and false
+		 * is returned if the plain square-and-multiply is estimated cheaper.
+		 */
+		bool FrobPower(const ZZ& e);
+		/** \brief Itoh-Tsujii inversion of a nonzero element of an extension field. */
+		void ItohTsujiiInv();
+	/** @} */
+	/****************//** \name Helpers for minimal polynomials ******************/
+	/** @{ */
+		/** \brief The minimal polynomial over the stem \a F by power projection.
+		 *
+		 * This element must not belong to the subfield of its \parent, which
+		 * must be a stem field, so that the degree of the result is known in advance.
+		 */
+		void projectionMinimalPolynomial(const Field<T>& F, FieldPolynomial<T>& res) const;
 	/** @} */
 
 	/****************//** \name Internal Constructors
@@ -790,12 +1039,19 @@ namespace FAAST {
 	 * Reserved for used by Field.
 	 * @{
 	 */
-		FieldElement(const Field<T>* p, const GFp& PBase, const GFpE& PExt, const bool b) throw() :
-			repBase(PBase), repExt(PExt), base(b), parent_field(p) {}
+		FieldElement(const Field<T>* p, const FieldElement<T>& e) throw() :
+		base(e.base), parent_field(p) {
+			if (base) new (storage.baseStorage) GFp(e.repBase());
+			else new (storage.extStorage) GFpE(e.repExt());
+		}
 		FieldElement(const Field<T>* p, const GFpE& P) throw() :
-			repExt(P), base(false), parent_field(p) {}
+		base(false), parent_field(p) {
+			new (storage.extStorage) GFpE(P);
+		}
 		FieldElement(const Field<T>* p, const GFp& P) throw() :
-			repBase(P), base(true), parent_field(p) {}
+		base(true), parent_field(p) {
+			new (storage.baseStorage) GFp(P);
+		}
 	/** @} */
 	/****************** Utility Routines ******************/
 		/**
@@ -25,6 +25,7 @@
 #include "Exceptions.hpp"
 #include <string>
 #include <vector>
+#include <new>
 
 namespace FAAST {
 	template <class T> class Field;
@@ -46,6 +47,48 @@ namespace FAAST {
 			const FieldPolynomial<T>& P, const FieldPolynomial<T>& Q,
 			const long d)
 	throw(NotInSameFieldException, BadParametersException);
+
+/****************** Batch inversion ******************/
+	template <class T> void
+	invertBatch(FieldPolynomial<T>& P, vector<long>& zeros) throw();
+
+/****************** Tuning ******************/
+	/**
+	 * \brief Measure the HalfGCD crossover for the fields of the degree of \a K.
+	 *
+	 * Under the crossover, HalfGCD() and XGCD() use the quadratic algorithm. Its best value
+	 * depends on the cost of the operations of the field, so it is measured separately for
+	 * each Infrastructure and each bucket of field degrees (the logarithm of the degree). Buckets
+	 * that have not been measured use the default Constants::HalfGCD_CROSSOVER.
+	 *
+	 * The measure takes a fraction of second. If \a file is given, the crossovers are first
+	 * loaded from it and the measure is skipped if the bucket of \a K is found there;
+	 * otherwise the file is rewritten with all the crossovers known for the Infrastructure \a T.
+	 * Use one file per Infrastructure.
+	 *
+	 * \param [in] K A field.
+	 * \param [in] file The name of a file holding the crossovers, or \c NULL.
+	 * \return The crossover for the fields of the degree of \a K.
+	 * \throw BadParametersException If \a file cannot be read or written.
+	 * \note This function is not thread-safe.
+	 * \relates FieldPolynomial
+	 */
+	template <class T> long
+	tuneHalfGCD(const Field<T>& K, const char* file = NULL)
+	throw(BadParametersException);
+	/**
+	 * \brief Write the crossovers measured by tuneHalfGCD() to \a o.
+	 * \relates FieldPolynomial
+	 */
+	template <class T> void saveHalfGCDCrossovers(ostream& o);
+	/**
+	 * \brief Read back the crossovers written by saveHalfGCDCrossovers().
+	 * \throw BadParametersException If the input is malformed or was written for another
+	 * Infrastructure.
+	 * \relates FieldPolynomial
+	 */
+	template <class T> void loadHalfGCDCrossovers(istream& in)
+	throw(BadParametersException);
 /****************** Class FieldPolynomial ******************/
 	/**
 	 * \ingroup Fields
@@ -144,6 +187,18 @@ namespace FAAST {
 				const FieldPolynomial<T>& P, const FieldPolynomial<T>& Q,
 				const long d)
 	throw(NotInSameFieldException, BadParametersException);
+	/**
+	 * \brief Invert the coefficients of \a P.
+	 *
+	 * The nonzero coefficients of degree up to the degree of \a P are replaced by
+	 * their inverses using invertBatch(FieldElement<T>*, const long, vector<long>&).
+	 *
+	 * \param [in,out] P A polynomial.
+	 * \param [out] zeros The degrees of the coefficients of \a P equal to 0, in increasing
+	 * order. All previous data are discarded.
+	 * \relates FieldPolynomial
+	 */
+	friend void invertBatch<T>(FieldPolynomial<T>& P, vector<long>& zeros) throw();
 
 	/** \name Local types
 	 * Local types defined in this class. They are aliases to simplify the access
@@ -168,14 +223,58 @@ namespace FAAST {
 
 	/****************** Members ******************/
 	/** \cond DEV */
-		/** \brief The \NTL representation of this polynomial if the \parent is a prime field. */
-		GFpX repBase;
-		/** \brief The \NTL representation of this polynomial if the \parent is an extension field. */
-		GFpEX repExt;
+		/** \brief The \NTL representation of this polynomial, a GFpX if the \parent
+		 * is a prime field, a GFpEX otherwise. Only the one selected by \a base is
+		 * alive, see repBase() and repExt(). */
+		union {
+			char baseStorage[sizeof(GFpX)];
+			char extStorage[sizeof(GFpEX)];
+			void* alignPointer;
+			long alignLong;
+			double alignDouble;
+		} storage;
 		/** \brief Whether the \parent of this polynomial is a prime or an extension field. */
 		bool base;
 		/** \brief The \parent. NULL if no \parent. */
 		const Field<T>* parent_field;
+
+		/** \brief The \NTL representation of this polynomial if \a base is set. */
+		GFpX& repBase() throw() {
+			return *reinterpret_cast<GFpX*>(storage.baseStorage);
+		}
+		/** \brief \copybrief repBase() */
+		const GFpX& repBase() const throw() {
+			return *reinterpret_cast<const GFpX*>(storage.baseStorage);
+		}
+		/** \brief The \NTL representation of this polynomial if \a base is not set. */
+		GFpEX& repExt() throw() {
+			return *reinterpret_cast<GFpEX*>(storage.extStorage);
+		}
+		/** \brief \copybrief repExt() */
+		const GFpEX& repExt() const throw() {
+			return *reinterpret_cast<const GFpEX*>(storage.extStorage);
+		}
+		/** \brief Construct the representation selected by \a base, equal to 0. */
+		void constructRep() throw() {
+			if (base) new (storage.baseStorage) GFpX();
+			else new (storage.extStorage) GFpEX();
+		}
+		/** \brief Destroy the representation selected by \a base. */
+		void destroyRep() throw() {
+			if (base) repBase().~GFpX();
+			else repExt().~GFpEX();
+		}
+		/** \brief Select the GFpX representation if \a b is set, the GFpEX one otherwise.
+		 *
+		 * If the selection changes, the old representation is destroyed and the new
+		 * one is 0.
+		 */
+		void setBase(const bool b) throw() {
+			if (b == base) return;
+			destroyRep();
+			base = b;
+			constructRep();
+		}
 	/** \endcond */
 
 
@@ -192,7 +291,7 @@ namespace FAAST {
 		 *
 		 * \see UndefinedFieldException, Field::zero(), FieldPolynomial(const FieldElement<T>&).
 		 */
-		FieldPolynomial() throw() : parent_field(NULL) {}
+		FieldPolynomial() throw() : base(true), parent_field(NULL) { constructRep(); }
 	/** @} */
 	/****************//** \name Properties ******************/
 	/** @{ */
@@ -577,12 +676,12 @@ namespace FAAST {
 		/** \brief Test to zero. */
 		bool isZero() const throw() {
 			return !parent_field ||
-				(base ? IsZero(repBase) : IsZero(repExt));
+				(base ? IsZero(repBase()) : IsZero(repExt()));
 		}
 		/** \brief Test to one. */
 		bool isOne() const throw() {
 			return parent_field &&
-				(base ? IsOne(repBase) : IsOne(repExt));
+				(base ? IsOne(repBase()) : IsOne(repExt()));
 		}
 		/** \brief Test if this polynomial has coefficients in F<sub>p</sub>.
 		 * \see toScalarPolynomial().
@@ -659,7 +758,7 @@ namespace FAAST {
 		ostream& print(ostream&, const string& varPoly, const vector<string>& varsField) const;
 	/** @} */
 	/****************** Destructor ******************/
-		~FieldPolynomial() throw() {}
+		~FieldPolynomial() throw() { destroyRep(); }
 
 
 	/*****************************************************/
@@ -673,12 +772,14 @@ namespace FAAST {
 	 * Reserved for used by Field.
 	 * @{
 	 */
-		FieldPolynomial(const Field<T>* p, const GFpX& PBase, const GFpEX& PExt, const bool b) throw() :
-			repBase(PBase), repExt(PExt), base(b), parent_field(p) {}
 		FieldPolynomial(const Field<T>* p, const GFpEX& P) throw() :
-			repExt(P), base(false), parent_field(p) {}
+		base(false), parent_field(p) {
+			new (storage.extStorage) GFpEX(P);
+		}
 		FieldPolynomial(const Field<T>* p, const GFpX& P) throw() :
-			repBase(P), base(true), parent_field(p) {}
+		base(true), parent_field(p) {
+			new (storage.baseStorage) GFpX(P);
+		}
 	/** @} */
 	/****************** Utility Routines ******************/
 		/**
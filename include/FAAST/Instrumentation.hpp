@@ -0,0 +1,193 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <ostream>
+
+namespace FAAST {
+	/**
+	 * \defgroup Instrumentation Instrumentation
+	 * FAAST can count the calls to its precomputations and to its most
+	 * expensive kernels, and measure the time they take. The counters are
+	 * kept per thread, so that they can be updated without locking, and
+	 * summed over all the threads by profile().
+	 *
+	 * The instrumentation is disabled by default: it is switched on and off
+	 * at run time by setInstrumentation(), and costs one test per probe when
+	 * disabled.
+	 *
+	 * \code
+	 * setInstrumentation(true);
+	 * resetProfile();
+	 * K.ArtinSchreierExtension();
+	 * dumpProfile(cout, profile());
+	 * \endcode
+	 *
+	 * Times are wall-clock times. A probe whose kernel is recursive counts all
+	 * the calls, but only measures the outermost one. When a computation is
+	 * split among several threads, the time spent by each thread is counted,
+	 * so that the cumulative time can exceed the elapsed time.
+	 * @{
+	 */
+
+	/** \brief The instrumented computations. */
+	enum Probe {
+		/** \brief Precomputing the (2p-1)-th cyclotomic polynomial. */
+		PROBE_CYCLOTOMIC,
+		/** \brief Precomputing the pseudotraces. See [\ref ISSAC "DFS '09", Section 5]. */
+		PROBE_PSEUDOTRACES,
+		/** \brief Precomputing the inverse of the derivative of the defining polynomial.
+		 * See [\ref ISSAC "DFS '09", Section 4]. */
+		PROBE_LIFTUP,
+		/** \brief Precomputing the coefficients of the trace form over the bivariate
+		 * basis. See [\ref ISSAC "DFS '09", Section 4]. */
+		PROBE_TRACEVEC,
+		/** \brief Building irreducible polynomials for base fields. */
+		PROBE_BUILDIRRED,
+		/** \brief Testing the irreducibility of polynomials defining base fields. */
+		PROBE_IRREDTEST,
+		/** \brief Testing the primality of characteristics. */
+		PROBE_PRIMETEST,
+		/** \brief Precomputing and inverting the matrix of the application
+		 * X<sup>p</sup> - X in base fields. See [\ref ISSAC "DFS '09", Section 6]. */
+		PROBE_ARTINMATRIX,
+		/** \brief Building a level of the primitive tower. See [\ref ISSAC "DFS '09", Section 3]. */
+		PROBE_BUILDSTEM,
+		/** \brief Push-down-rec, the core of pushDown(). */
+		PROBE_PUSHDOWNREC,
+		/** \brief Push-down-rec*, the core of liftUp(). */
+		PROBE_TRANSPUSHDOWNREC,
+		/** \brief The transposed multiplications (step 2 of liftUp()). */
+		PROBE_TRANSPOSEDMUL,
+		/** \brief mod*, used by liftUp() when the extension is built
+		 * modulo X<sup>p</sup> - X - x<sup>2p-1</sup>. */
+		PROBE_TRANSMOD,
+		/** \brief The final truncated product and the multiplication by
+		 * the lift-up helper in liftUp(). */
+		PROBE_LIFTUPMUL,
+		/** \brief The p<sup>j</sup>-th iterated Frobenius. See [\ref ISSAC "DFS '09", Section 5]. */
+		PROBE_BIGFROB,
+		/** \brief Cantor's algorithm computing the defining polynomials of the tower. */
+		PROBE_CANTOR89,
+		/** \brief Couveignes' algorithm solving Artin-Schreier equations. */
+		PROBE_COUVEIGNES00,
+		/** \brief Precomputing the tables of the iterated Frobenius in base fields. */
+		PROBE_FROBENIUS,
+		/** \brief Precomputing the factorials and the Bernoulli numbers modulo p. */
+		PROBE_BINOMIALS,
+		/** \brief Precomputing the change of basis of fields that are not on
+		 * the stem. See [\ref ISSAC "DFS '09", Section 6]. */
+		PROBE_ISOMORPHISM,
+		/** \brief The number of probes. */
+		PROBES
+	};
+
+	/** \brief The counters of one probe. */
+	typedef struct ProbeCounters {
+		/** \brief The number of calls. */
+		unsigned long calls;
+		/** \brief The cumulative time, in seconds. */
+		double time;
+		/** \brief The longest call, in seconds. */
+		double maxtime;
+		/** \brief An estimate of the size of the results, as a number of
+		 * coefficients in the prime field. Multiply by the size of the
+		 * representation of an element of F<sub>p</sub> to get the memory. */
+		unsigned long coefficients;
+
+		ProbeCounters() : calls(0), time(0), maxtime(0), coefficients(0) {}
+		/** \brief Accumulate \a c into these counters. */
+		void operator+=(const ProbeCounters& c) throw();
+	} ProbeCounters;
+
+	/** \brief A snapshot of the counters of all the probes. */
+	typedef struct Profile {
+		/** \brief The counters, indexed by Probe. */
+		ProbeCounters probes[PROBES];
+		/** \brief The counters of probe \a p. */
+		const ProbeCounters& operator[](const Probe p) const { return probes[p]; }
+	} Profile;
+
+	/** \brief Switch the instrumentation on or off. It is off by default. */
+	void setInstrumentation(const bool on) throw();
+	/** \brief Whether the instrumentation is on. See setInstrumentation(). */
+	bool getInstrumentation() throw();
+	/**
+	 * \brief The counters of all the threads, summed.
+	 *
+	 * The counters of the threads that have exited are included. Counters
+	 * being updated concurrently may be slightly out of date.
+	 */
+	Profile profile() throw();
+	/** \brief The counters of the calling thread. */
+	Profile threadProfile() throw();
+	/**
+	 * \brief Set the counters of all the threads to zero.
+	 *
+	 * \warning The counters of the other threads are not locked: only call
+	 * this function when no probe is running, e.g. when no other thread is
+	 * doing computations in a field. To measure a computation while others
+	 * are running, take the difference of two calls to profile() instead.
+	 */
+	void resetProfile() throw();
+	/** \brief The name of probe \a p, as used by dumpProfile(). */
+	const char* probeName(const Probe p) throw();
+	/**
+	 * \brief Write \a prof in a machine-readable form.
+	 *
+	 * The output is a tab-separated table with a header line
+	 * <tt>probe calls time maxtime coefficients</tt> followed by one line per probe.
+	 */
+	void dumpProfile(std::ostream& out, const Profile& prof);
+
+	/**
+	 * \cond DEV
+	 * \brief Count one call to a probe and measure it, until the end of the scope.
+	 *
+	 * Does nothing if the instrumentation is off when it is constructed.
+	 */
+	class ProbeScope {
+	private:
+		Probe probe;
+		bool active;
+		double start;
+		/* Copy prohibited */
+		ProbeScope(const ProbeScope&);
+		void operator=(const ProbeScope&);
+	public:
+		/** \brief Start measuring a call to \a p. */
+		explicit ProbeScope(const Probe p) throw();
+		/** \brief Stop measuring. */
+		~ProbeScope() throw();
+		/** \brief Account for \a n coefficients in F<sub>p</sub> computed
+		 * by this call. */
+		void coefficients(const unsigned long n) throw();
+	};
+	/** \endcond */
+
+	/**
+	 * @}
+	 */
+}
+
+#endif /*INSTRUMENTATION_H_*/
@@ -0,0 +1,137 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#ifndef SUBPRODUCTTREE_H_
+#define SUBPRODUCTTREE_H_
+
+#include "Field.hpp"
+#include <vector>
+
+namespace FAAST {
+	/**
+	 * \ingroup Fields
+	 * \brief The subproduct tree of a set of points of a finite field.
+	 *
+	 * The leaves of the tree are the polynomials X - \a a<sub>i</sub>, for \a a<sub>0</sub>, ...,
+	 * \a a<sub>n-1</sub> elements of a finite field, and each node is the product of its two
+	 * children. Once built, the tree evaluates polynomials at all the points at once by successive
+	 * remainders, and interpolates values at the points, in quasi-linear time. A tree can be
+	 * reused for any number of evaluations and interpolations on the same points.
+	 *
+	 * \code
+	 * SubproductTree<T> tree(points);
+	 * vector<FieldElement<T> > values;
+	 * tree.evaluate(P, values);
+	 * FieldPolynomial<T> Q;
+	 * tree.interpolate(values, Q);   // Q == P % tree.root()
+	 * \endcode
+	 *
+	 * The points may belong to any field of the \ref Field_lattices "lattice", provided
+	 * they all belong to the same one.
+	 *
+	 * \tparam T The \ref Infrastructures "Infrastructure".
+	 */
+	template <class T> class SubproductTree {
+	public:
+	/****************//** \name Constructors ******************/
+	/** @{ */
+		/**
+		 * \brief Build the tree of \a points.
+		 *
+		 * \param [in] points A non-empty vector of elements of the same field. Elements created
+		 * through the \link FieldElement::FieldElement() default constructor\endlink stand for
+		 * zero.
+		 * \throw BadParametersException If \a points is empty.
+		 * \throw UndefinedFieldException If no element of \a points has a \parent.
+		 * \throw NotInSameFieldException If the elements of \a points do not belong to the same field.
+		 */
+		explicit SubproductTree(const vector<FieldElement<T> >& points)
+		throw(BadParametersException, UndefinedFieldException, NotInSameFieldException);
+	/** @} */
+	/****************//** \name Properties ******************/
+	/** @{ */
+		/** \brief The number of points. */
+		long size() const throw() { return points.size(); }
+		/** \brief The field of the points. */
+		const Field<T>& parent() const throw() { return *field; }
+		/** \brief The product of the X - \a a<sub>i</sub>. */
+		const FieldPolynomial<T>& root() const throw() { return tree.back()[0]; }
+		/** \brief The <i>i</i>-th point. */
+		const FieldElement<T>& point(const long i) const throw() { return points[i]; }
+	/** @} */
+	/****************//** \name Evaluation and interpolation ******************/
+	/** @{ */
+		/**
+		 * \brief Evaluate \a P at all the points.
+		 *
+		 * \param [in] P A polynomial whose \parent is the field of the points or coercible to it.
+		 * \param [out] values A vector that receives the value of \a P at the <i>i</i>-th
+		 * point at position \a i.
+		 * \throw IllegalCoercionException If \a P cannot be coerced to the field of the points.
+		 */
+		void evaluate(const FieldPolynomial<T>& P, vector<FieldElement<T> >& values)
+		const throw(IllegalCoercionException);
+		/**
+		 * \brief The polynomial of degree less than size() taking the given values at the points.
+		 *
+		 * The weights of the Lagrange interpolation formula are computed by the first call and
+		 * kept for the following ones.
+		 *
+		 * \param [in] values A vector of size() elements of the field of the points, or
+		 * coercible to it.
+		 * \param [out] P A polynomial to hold the result.
+		 * \throw BadParametersException If \a values has not size() elements or if the points
+		 * are not distinct.
+		 * \throw IllegalCoercionException If an element of \a values cannot be coerced to the
+		 * field of the points.
+		 */
+		void interpolate(const vector<FieldElement<T> >& values, FieldPolynomial<T>& P)
+		const throw(BadParametersException, IllegalCoercionException);
+	/** @} */
+
+	/** \cond DEV */
+	private:
+		/** \brief The field of the points */
+		const Field<T>* field;
+		/** \brief The points */
+		vector<FieldElement<T> > points;
+		/** \brief The levels of the tree, from the leaves to the root.
+		 * The node i of a level is the product of the nodes 2i and 2i+1
+		 * of the level below, or a copy of the node 2i if it is the last one.
+		 */
+		vector<vector<FieldPolynomial<T> > > tree;
+		/** \brief The inverses of the derivative of root() at the points,
+		 * empty until the first interpolation
+		 */
+		mutable vector<FieldElement<T> > weights;
+		/** \brief Whether \ref weights has been published */
+		mutable volatile bool weighted;
+		/** \brief Protects \ref weights */
+		mutable Mutex lock;
+
+		/* Copy prohibited */
+		SubproductTree(const SubproductTree<T>&);
+		void operator=(const SubproductTree<T>&);
+	/** \endcond */
+	};
+}
+
+#endif /*SUBPRODUCTTREE_H_*/
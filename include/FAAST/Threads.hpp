@@ -0,0 +1,295 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#ifndef THREADS_H_
+#define THREADS_H_
+
+#include <pthread.h>
+#include <NTL/tools.h>
+#include "Exceptions.hpp"
+
+namespace FAAST {
+	/**
+	 * \defgroup Threads Multi-threading
+	 * FAAST can be used from several threads at the same time, provided
+	 * that \NTL has been compiled with \c NTL_THREADS=on. In that case
+	 * \NTL keeps its current moduli (the \c zz_p, \c ZZ_p, \c zz_pE, \c ZZ_pE
+	 * and \c GF2E contexts) in thread-local storage and each thread
+	 * installs the context of the field it is working in through
+	 * Field::switchContext(). Different threads can then work
+	 * concurrently in the same field or in different levels of
+	 * the same tower.
+	 *
+	 * Precomputations that are computed on demand (pseudotraces, lift-up
+	 * helper, Artin matrix, cyclotomic context) are protected by a lock
+	 * held by the stem field they belong to.
+	 *
+	 * When \NTL is not thread-safe, FAAST must be used by one thread at
+	 * a time. threadsSupported() tells which situation applies.
+	 *
+	 * Independently, some algorithms can split their own work among
+	 * several threads. All of them share one pool of worker threads,
+	 * whose size is set by setThreads() and capped by setCPUShare(),
+	 * and which balances the work by stealing.
+	 * pushDown(), liftUp(), Cantor's algorithm and the half-GCD
+	 * split their work when the input is larger than the grain size set
+	 * by setGrainSize(); the Frobenius computations and the minimal
+	 * polynomials do so on fields higher than the height set by
+	 * setParallelHeight(). The
+	 * results are identical to the sequential ones. These settings are
+	 * global and should not be changed while a computation is running.
+	 *
+	 * This module also offers the small set of portable primitives
+	 * (based on POSIX threads) that FAAST uses internally.
+	 * @{
+	 */
+
+	/**
+	 * \brief Whether FAAST can be used concurrently from several threads.
+	 *
+	 * \return \c true if the \NTL library FAAST has been compiled against
+	 * keeps its moduli in thread-local storage.
+	 */
+	inline bool threadsSupported() throw() {
+#ifdef NTL_THREADS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * \brief Wall-clock time in seconds.
+	 *
+	 * Unlike \NTL's \c GetTime(), which measures the CPU time of the
+	 * whole process, this is suited to measure multi-threaded code.
+	 */
+	double GetWallTime() throw();
+
+	/**
+	 * \brief A mutual exclusion lock.
+	 *
+	 * A recursive mutex can be locked several times by the same thread,
+	 * it is released when it has been unlocked as many times.
+	 */
+	class Mutex {
+	private:
+		pthread_mutex_t mutex;
+		/* Copy prohibited */
+		Mutex(const Mutex&);
+		void operator=(const Mutex&);
+	public:
+		/** \brief Build a mutex, recursive if \a recursive is true. */
+		Mutex(const bool recursive = false) throw();
+		~Mutex() throw() { pthread_mutex_destroy(&mutex); }
+		/** \brief Acquire the lock, waiting for it if needed. */
+		void lock() throw() { pthread_mutex_lock(&mutex); }
+		/** \brief Release the lock. */
+		void unlock() throw() { pthread_mutex_unlock(&mutex); }
+	};
+
+	/**
+	 * \brief Holds a Mutex for the lifetime of the object.
+	 */
+	class ScopedLock {
+	private:
+		Mutex& mutex;
+		/* Copy prohibited */
+		ScopedLock(const ScopedLock&);
+		void operator=(const ScopedLock&);
+	public:
+		/** \brief Acquire \a m. */
+		explicit ScopedLock(Mutex& m) throw() : mutex(m) { mutex.lock(); }
+		/** \brief Release the mutex. */
+		~ScopedLock() throw() { mutex.unlock(); }
+	};
+
+	/**
+	 * \brief A variable having a distinct value in each thread.
+	 *
+	 * The value of each thread is default constructed the first time
+	 * the thread accesses it, and destroyed when the thread exits.
+	 *
+	 * \tparam V A default constructible type.
+	 */
+	template <class V> class ThreadLocal {
+	private:
+		pthread_key_t key;
+		static void destroy(void* v) { delete static_cast<V*>(v); }
+		/* Copy prohibited */
+		ThreadLocal(const ThreadLocal<V>&);
+		void operator=(const ThreadLocal<V>&);
+	public:
+		ThreadLocal() throw() { pthread_key_create(&key, &destroy); }
+		~ThreadLocal() throw() { pthread_key_delete(key); }
+		/** \brief The value seen by the calling thread. */
+		V& get() const {
+			void* v = pthread_getspecific(key);
+			if (!v) {
+				v = new V();
+				pthread_setspecific(key, v);
+			}
+			return *static_cast<V*>(v);
+		}
+	};
+
+	/**
+	 * \brief Set the number of threads used by the parallel algorithms.
+	 *
+	 * The default is 1, meaning that all algorithms run sequentially in the
+	 * calling thread. With \a n threads, the calling thread is helped by
+	 * \a n - 1 worker threads, created the first time they are needed.
+	 *
+	 * \throws BadParametersException If \a n is less than one.
+	 * \throws NotSupportedException If \a n is greater than one and
+	 * threadsSupported() is false.
+	 */
+	void setThreads(const long n) throw(BadParametersException, NotSupportedException);
+	/**
+	 * \brief The number of threads used by the parallel algorithms.
+	 *
+	 * This is the value given to setThreads(), capped by setCPUShare().
+	 */
+	long getThreads() throw();
+	/**
+	 * \brief Cap the share of the processors used by the parallel algorithms.
+	 *
+	 * When FAAST is embedded in a larger application, this limits the number of
+	 * threads it uses to \a share times hardwareThreads(), rounded down but
+	 * at least one, whatever the value given to setThreads(). The default
+	 * is 1, that is no cap.
+	 *
+	 * \throws BadParametersException If \a share is not in the interval (0, 1].
+	 */
+	void setCPUShare(const double share) throw(BadParametersException);
+	/** \brief The share of the processors used by the parallel algorithms. See setCPUShare(). */
+	double getCPUShare() throw();
+	/** \brief The number of processors online. */
+	long hardwareThreads() throw();
+	/**
+	 * \brief Set the grain size of the parallel algorithms.
+	 *
+	 * Problems whose size (usually the length of a polynomial) is smaller than
+	 * \a g are not split into parallel tasks.
+	 *
+	 * \throws BadParametersException If \a g is less than one.
+	 */
+	void setGrainSize(const long g) throw(BadParametersException);
+	/** \brief The grain size of the parallel algorithms. See setGrainSize(). */
+	long getGrainSize() throw();
+	/**
+	 * \brief Set the least height at which recursive algorithms on towers run in parallel.
+	 *
+	 * Algorithms that recurse down the tower, such as the Frobenius
+	 * computations of FieldElement, only split their work on fields whose
+	 * Artin-Schreier height is at least \a h, so that small towers do not
+	 * pay the scheduling overhead.
+	 *
+	 * \throws BadParametersException If \a h is less than one.
+	 */
+	void setParallelHeight(const long h) throw(BadParametersException);
+	/** \brief The least height at which recursive algorithms run in parallel. See setParallelHeight(). */
+	long getParallelHeight() throw();
+
+	/**
+	 * \cond DEV
+	 * \brief A full memory barrier.
+	 *
+	 * Used to publish a value computed by one thread: the value is
+	 * written, then the barrier, then the flag telling that it is
+	 * ready. Readers check the flag, then the barrier, then read.
+	 */
+	inline void memoryBarrier() throw() { __sync_synchronize(); }
+
+	/**
+	 * \brief A unit of work that can be run by another thread.
+	 *
+	 * \see TaskGroup.
+	 */
+	class Task {
+	public:
+		virtual ~Task() {}
+		/** \brief Do the work. */
+		virtual void run() = 0;
+	};
+
+	/**
+	 * \brief A set of tasks running concurrently.
+	 *
+	 * Tasks are queued by spawn() and run by the worker threads; wait()
+	 * returns when all of them are done. Each worker queues the tasks it
+	 * spawns in its own deque, idle workers steal the oldest tasks of the
+	 * others. While waiting, the calling thread runs the tasks of the group
+	 * that have not been stolen yet, so that groups can be nested; it never
+	 * runs tasks of other groups, so that locks held by the caller are not
+	 * reentered.
+	 *
+	 * \warning Tasks do not inherit the \NTL context of the thread that
+	 * spawns them, they must install their context themselves. Similarly,
+	 * the context of the calling thread is undefined after wait().
+	 */
+	class TaskGroup {
+	private:
+		long pending;
+		bool failed;
+		/* Copy prohibited */
+		TaskGroup(const TaskGroup&);
+		void operator=(const TaskGroup&);
+	public:
+		TaskGroup() throw() : pending(0), failed(false) {}
+		/** \brief Wait for the tasks still running. */
+		~TaskGroup() throw();
+		/**
+		 * \brief Run \a t, concurrently if getThreads() is greater than one.
+		 *
+		 * The group does not take ownership of \a t, that must live
+		 * until wait() returns.
+		 */
+		void spawn(Task& t);
+		/**
+		 * \brief Wait for all the spawned tasks to finish.
+		 *
+		 * \throws FAASTException If one of the tasks has thrown an exception.
+		 */
+		void wait() throw(FAASTException);
+
+		friend void runTask(Task* t, TaskGroup* g) throw();
+	};
+
+	/**
+	 * \brief Run \a a and \a b, concurrently if getThreads() is greater than one.
+	 *
+	 * \a a is run by the calling thread while \a b may be stolen by a worker.
+	 * Calls can be nested, this is the building block of the recursive
+	 * algorithms.
+	 *
+	 * \throws FAASTException If \a b has thrown an exception. Exceptions
+	 * thrown by \a a are propagated once \a b is done.
+	 */
+	void forkJoin(Task& a, Task& b);
+	/** \endcond */
+
+	/**
+	 * @}
+	 */
+}
+
+#endif /*THREADS_H_*/
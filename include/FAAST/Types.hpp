@@ -45,8 +45,32 @@ NTL_CLIENT
 namespace FAAST {
 	/** \brief A structure to hold predefined constants depending on the type. */
 	struct Constants {
+		/** \brief The number of buckets of field degrees. */
+		enum { BUCKETS = 64 };
+		/** \brief The degree under which HalfGCD switches to the iterative
+		 * algorithm, in fields whose crossover has not been tuned. */
 		mutable long HalfGCD_CROSSOVER;
-		Constants(const long h) : HalfGCD_CROSSOVER(h) {}
+		/** \brief The crossovers measured by tuneHalfGCD(), by bucket of
+		 * field degrees, 0 if not measured. */
+		mutable long HalfGCD_TUNED[BUCKETS];
+		/** \brief The field degree from which FieldElement::self_inv() uses the
+		 * Itoh-Tsujii inversion, 0 if never. */
+		mutable long ItohTsujii_CROSSOVER;
+		Constants(const long h, const long it = 0) :
+		HalfGCD_CROSSOVER(h), ItohTsujii_CROSSOVER(it) {
+			for (long i = 0 ; i < BUCKETS ; i++) HalfGCD_TUNED[i] = 0;
+		}
+		/** \brief The bucket of fields of degree \a d, the logarithm of \a d. */
+		static long bucket(long d) {
+			long b = 0;
+			while (d > 1 && b < BUCKETS - 1) { d >>= 1; b++; }
+			return b;
+		}
+		/** \brief The HalfGCD crossover in fields of degree \a d. */
+		long halfGCDCrossover(const long d) const {
+			const long c = HalfGCD_TUNED[bucket(d)];
+			return c > 0 ? c : HalfGCD_CROSSOVER;
+		}
 	};
 
 	/**
@@ -172,6 +196,8 @@ namespace FAAST {
 		typedef zz_pXModulus    GFpXModulus;
 		/** \brief Pre-condtioned polynomials over the field F<sub>p</sub>. */
 		typedef zz_pXMultiplier GFpXMultiplier;
+		/** \brief Pre-computed powers of a polynomial, for modular composition. */
+		typedef zz_pXArgument   GFpXArgument;
 
 		/** \brief predefined constants */
 		static const Constants consts;
@@ -215,6 +241,8 @@ namespace FAAST {
 		typedef ZZ_pXModulus    GFpXModulus;
 		/** \brief \copybrief zz_p_Algebra::GFpXMultiplier */
 		typedef ZZ_pXMultiplier GFpXMultiplier;
+		/** \brief \copybrief zz_p_Algebra::GFpXArgument */
+		typedef ZZ_pXArgument   GFpXArgument;
 
 		/** \brief \copybrief zz_p_Algebra::consts */
 		static const Constants consts;
@@ -255,6 +283,8 @@ namespace FAAST {
 		typedef GF2XModulus         GFpXModulus;
 		/** \brief \copybrief zz_p_Algebra::GFpXMultiplier */
 		typedef GF2XTransMultiplier GFpXMultiplier;
+		/** \brief \copybrief zz_p_Algebra::GFpXArgument */
+		typedef GF2XArgument        GFpXArgument;
 
 		/** \brief \copybrief zz_p_Algebra::consts */
 		static const Constants consts;
@@ -105,6 +105,35 @@ namespace FAAST {
 	template <class T> void compose
 	(typename T::GFpX& res, const typename T::GFpX& Q,
 	const typename T::GFpX& R, const typename T::BigInt& p);
+	/**
+	 *  \brief Compute the Taylor shift \a Q(X+c) for \a c = &plusmn;1.
+	 *
+	 *  Specialization of compose() to \a R = X&plusmn;1. It uses
+	 *  (X+c)<sup>p<sup>k</sup></sup> = X<sup>p<sup>k</sup></sup> + c
+	 *  to shift blocks of coefficients in place, using only additions.
+	 *
+	 *  \param [out] res A polynomial to hold the result.
+	 *  \param [in] Q A polynomial.
+	 *  \param [in] c Either 1 or -1.
+	 *  \param [in] p The characteristic of the base field of \a Q. Observe that NTL's
+	 *  			modulus has to be set accordingly.
+	 */
+	template <class T> void taylorShift(typename T::GFpX& res,
+	const typename T::GFpX& Q, const long c, const typename T::BigInt& p);
+	/**
+	 *  \brief Compute the composition \a Q(X<sup>p</sup> - X).
+	 *
+	 *  Specialization of compose() to \a R = X<sup>p</sup> - X. It uses
+	 *  (X<sup>p</sup> - X)<sup>p<sup>k</sup></sup> = X<sup>p<sup>k+1</sup></sup> - X<sup>p<sup>k</sup></sup>
+	 *  so that Horner's rule only needs shifted subtractions in place.
+	 *
+	 *  \param [out] res A polynomial to hold the result.
+	 *  \param [in] Q A polynomial.
+	 *  \param [in] p The characteristic of the base field of \a Q. Observe that NTL's
+	 *  			modulus has to be set accordingly.
+	 */
+	template <class T> void artinSchreierCompose(typename T::GFpX& res,
+	const typename T::GFpX& Q, const typename T::BigInt& p);
 	/**
 	 *  \brief Compute the <i>n</i>-th cyclotomic polynomial modulo \a p.
 	 *
@@ -25,5 +25,8 @@
 #include "FAAST/Exceptions.hpp"
 #include "FAAST/Types.hpp"
 #include "FAAST/Field.hpp"
+#include "FAAST/SubproductTree.hpp"
+#include "FAAST/Threads.hpp"
+#include "FAAST/Instrumentation.hpp"
 
 #endif /*ARTINSCHREIER_H_*/
@@ -20,23 +20,52 @@
 	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 namespace FAAST {
-	/* The algorithm ApproximateAS from Section 6 */
+	/* The algorithm ApproximateAS from Section 6.
+	 *
+	 * With V = sum v_j X^j and W the input, it solves
+	 *   V(X + tr) - V(X) = W(X),  V(0) = 0.
+	 * Writing D for the derivative, the shift by tr is exp(tr D), so
+	 *   V = 1/tr Integral(B(tr D) W),  B(z) = z/(e^z - 1)
+	 * all of this being well defined in degree less than p. The
+	 * action of B(tr D) is a single product of polynomials, once the
+	 * k-th coefficient of W is multiplied by k!.
+	 */
 	template <class T> void approximateAS(
-	vector<FieldElement<T> >& v, const FieldElement<T>& tr) {
+	vector<FieldElement<T> >& v, const FieldElement<T>& tr,
+	const typename T::VecGFp& fact, const typename T::VecGFp& invfact,
+	const typename T::GFpX& bernoulli) {
 		const Field<T>& parent = v[0].parent();
-		for (long j = long(parent.p) - 1 ; j >= 1 ; j--) {
-			FieldElement<T> t = tr;
-			FieldElement<T> binom =
-				parent.primeField().scalar(j);
-			v[j] = v[j-1];
-			for (long h = j + 1 ; h <= long(parent.p) - 1 ; h++) {
-				t *= tr;
-				binom *= parent.primeField().scalar(h);
-				binom /= parent.primeField().scalar(h - j + 1);
-				v[j] -= v[h] * (t * binom);
+		const Field<T>& prime = parent.primeField();
+		const long p = long(parent.p);
+
+		// A = sum b_n tr^n Y^n, R = sum m! w_m Y^(p-2-m)
+		FieldPolynomial<T> A, R;
+		FieldElement<T> t = tr.parent().one();
+		for (long n = 0 ; n <= p - 2 ; n++) {
+			if (coeff(bernoulli, n) != 0)
+				A.setCoeff(n, parent.one() *
+					(t * prime.fromInfrastructure(coeff(bernoulli, n))));
+			t *= tr;
+		}
+		for (long m = 0 ; m <= p - 2 ; m++) {
+			if (!v[m].isZero())
+				R.setCoeff(p - 2 - m,
+					v[m] * prime.fromInfrastructure(fact[m]));
+		}
+		R *= A;
+
+		// v_(k+1) = coefficient p-2-k of R, divided by (k+1)! tr
+		const FieldElement<T> itr = tr.parent().one() / tr;
+		for (long k = p - 2 ; k >= 0 ; k--) {
+			FieldElement<T> c;
+			R.getCoeff(p - 2 - k, c);
+			if (c.isZero()) {
+				v[k+1] = parent.zero();
+			} else {
+				c *= prime.fromInfrastructure(invfact[k+1]);
+				v[k+1] = c * itr;
+				v[k+1] >>= parent;
 			}
-			v[j] /= tr * parent.primeField().scalar(j);
-			v[j] >>= parent;
 		}
 		v[0] = parent.zero();
 	}
@@ -50,6 +79,7 @@ namespace FAAST {
 		if (alpha.trace() != 0)
 			throw FAASTException("Bad input to couveignes00.");
 #endif
+		ProbeScope probe(PROBE_COUVEIGNES00);
 		// step 0
 		if (alpha.isZero()) {
 			res = alpha;
@@ -61,24 +91,24 @@ namespace FAAST {
 		// step 1
 		if (i == 0) {
 			parent.switchContext();
-			const MatGFp& artin = parent.getArtinMatrix();
+			parent.getArtinMatrix();
 #ifdef FAAST_DEBUG
 			if (parent.stem->artinLine < 0)
 				throw FAASTException("Bad Artin Matrix.");
 #endif
 			VecGFp low, high;
-			VectorCopy(low, rep(alpha.repExt), parent.stem->artinLine);
-			VectorCopy(high, RightShift(rep(alpha.repExt),
+			VectorCopy(low, rep(alpha.repExt()), parent.stem->artinLine);
+			VectorCopy(high, RightShift(rep(alpha.repExt()),
 				parent.stem->artinLine+1),
 				parent.d - 1 - parent.stem->artinLine);
 			append(low, high);
-			// apply the artin matrix
-			VecGFp resV = artin * low;
+			// solve with the artin matrix
+			VecGFp resV;
+			parent.solveArtin(resV, low);
 			GFpX resX; conv(resX, resV);
 			resX <<= 1;
-			conv(res.repExt, resX);
-			res.repBase = 0;
-			res.base = false;
+			res.setBase(false);
+			conv(res.repExt(), resX);
 			res.parent_field = &parent;
 			return;
 		}
@@ -93,7 +123,10 @@ namespace FAAST {
 		if (etas[long(parent.p)-1] != 0)
 			throw FAASTException("Error in couveignes00.");
 #endif
-		approximateAS<T>(etas, parent.stem->alpha->trace());
+		const Field<T>& prime = parent.primeField();
+		approximateAS<T>(etas, parent.stem->alpha->trace(),
+			prime.getFactorials(), prime.getInvFactorials(),
+			prime.getBernoulli());
 		// step 4
 		vector<FieldElement<T> > alphas;
 		FAAST::pushDown(alpha, alphas);
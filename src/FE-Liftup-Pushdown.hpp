@@ -84,24 +84,52 @@ namespace FAAST {
 		W[long(p)-1] += Lead;
 	}
 
+	template <class T> class PushDownTask;
+	template <class T> class TransPushDownTask;
+
 	// The routine Push-down-rec from Section 4
+	//
+	// If F is given and more than one thread is available, the
+	// blocks are pushed down concurrently, each task running in
+	// the context of F, then combined in the same order as in the
+	// sequential algorithm.
 	template <class T> void pushDownRec(
 	const typename T::GFpX& V, long start, long end,
-	vector<typename T::GFpX>& W, const typename T::BigInt& p) {
+	vector<typename T::GFpX>& W, const typename T::BigInt& p,
+	const Field<T>* F = NULL) {
 		typedef typename T::GFpX   GFpX;
 		typedef typename T::BigInt BigInt;
 
 		long degree = end - start;
+		ProbeScope probe(PROBE_PUSHDOWNREC);
+		probe.coefficients(degree + 1);
 		long k = NumPits(p, degree);
 		// if deg(V) >= p, cut in p slices and apply recursively
 		if (k > 1) {
-			vector<GFpX> Wtmp;
 			W.clear(); W.resize(p);
 			long splitdegree = power_long(p, k-1);
-			for (long i = start + splitdegree * (degree / splitdegree) ; i >= start ; i -= splitdegree) {
-				pushDownRec<T>(V, i, min(i+splitdegree-1, end), Wtmp, p);
-				MulMod<T>(W, k-1, p);
-				for (BigInt j = 0 ; j < p ; j++) W[j] += Wtmp[j];
+			if (F && getThreads() > 1 && degree >= getGrainSize()) {
+				long blocks = degree / splitdegree + 1;
+				vector<PushDownTask<T> > tasks(blocks);
+				TaskGroup group;
+				for (long b = 0 ; b < blocks ; b++) {
+					long i = start + b*splitdegree;
+					tasks[b].set(F, V, i, min(i+splitdegree-1, end), p);
+					group.spawn(tasks[b]);
+				}
+				group.wait();
+				F->switchContext();
+				for (long b = blocks - 1 ; b >= 0 ; b--) {
+					MulMod<T>(W, k-1, p);
+					for (BigInt j = 0 ; j < p ; j++) W[j] += tasks[b].W[j];
+				}
+			} else {
+				vector<GFpX> Wtmp;
+				for (long i = start + splitdegree * (degree / splitdegree) ; i >= start ; i -= splitdegree) {
+					pushDownRec<T>(V, i, min(i+splitdegree-1, end), Wtmp, p, F);
+					MulMod<T>(W, k-1, p);
+					for (BigInt j = 0 ; j < p ; j++) W[j] += Wtmp[j];
+				}
 			}
 		}
 		// if deg(V) < p, then
@@ -115,24 +143,55 @@ namespace FAAST {
 	}
 
 	// The routine Push-down-rec* from Section 4
+	//
+	// If F is given and more than one thread is available, the
+	// inputs of the blocks are computed first, then the blocks are
+	// processed concurrently into separate polynomials and copied
+	// into V.
 	template <class T> void TransPushDownRec(
 	vector<typename T::GFpX>& W, typename T::GFpX& V,
-	long start, long end, const typename T::BigInt& p) {
+	long start, long end, const typename T::BigInt& p,
+	const Field<T>* F = NULL) {
 		typedef typename T::GFpX   GFpX;
 		typedef typename T::BigInt BigInt;
 
 		long degree = end - start;
+		ProbeScope probe(PROBE_TRANSPUSHDOWNREC);
+		probe.coefficients(degree + 1);
 		long k = NumPits(p, degree);
 		// if deg(V) >= p, cut in p slices and apply recursively
 		if (k > 1) {
-			vector<GFpX> Wtmp; Wtmp.resize(p);
 			long splitdegree = power_long(p, k-1);
-			SetCoeff(V, end); // hack
-			for (long i = start ; i <= end ; i += splitdegree) {
-				for (BigInt j = 0 ; j < p ; j++)
-					Wtmp[j] = trunc(W[j], splitdegree/p);
-				TransMulMod<T>(W, k-1, p);
-				TransPushDownRec<T>(Wtmp, V, i, min(i+splitdegree-1, end), p);
+			if (F && getThreads() > 1 && degree >= getGrainSize()) {
+				long blocks = degree / splitdegree + 1;
+				vector<TransPushDownTask<T> > tasks(blocks);
+				for (long b = 0 ; b < blocks ; b++) {
+					long i = start + b*splitdegree;
+					tasks[b].set(F, min(i+splitdegree-1, end) - i, p);
+					for (BigInt j = 0 ; j < p ; j++)
+						tasks[b].W[j] = trunc(W[j], splitdegree/p);
+					TransMulMod<T>(W, k-1, p);
+				}
+				TaskGroup group;
+				for (long b = 0 ; b < blocks ; b++)
+					group.spawn(tasks[b]);
+				group.wait();
+				F->switchContext();
+				SetCoeff(V, end); // hack
+				for (long b = blocks - 1 ; b >= 0 ; b--) {
+					long i = start + b*splitdegree;
+					for (long h = tasks[b].end ; h >= 0 ; h--)
+						SetCoeff(V, i+h, coeff(tasks[b].V, h));
+				}
+			} else {
+				vector<GFpX> Wtmp; Wtmp.resize(p);
+				SetCoeff(V, end); // hack
+				for (long i = start ; i <= end ; i += splitdegree) {
+					for (BigInt j = 0 ; j < p ; j++)
+						Wtmp[j] = trunc(W[j], splitdegree/p);
+					TransMulMod<T>(W, k-1, p);
+					TransPushDownRec<T>(Wtmp, V, i, min(i+splitdegree-1, end), p, F);
+				}
 			}
 		}
 		else {
@@ -141,6 +200,48 @@ namespace FAAST {
 		}
 	}
 
+	/* A block of the parallel pushDownRec */
+	template <class T> class PushDownTask : public Task {
+	public:
+		const Field<T>* F;
+		const typename T::GFpX* V;
+		long start, end;
+		typename T::BigInt p;
+		vector<typename T::GFpX> W;
+
+		void set(const Field<T>* K, const typename T::GFpX& P,
+		const long s, const long e, const typename T::BigInt& c) {
+			F = K; V = &P; start = s; end = e; p = c;
+		}
+		void run() {
+			F->switchContext();
+			pushDownRec<T>(*V, start, end, W, p, F);
+		}
+	};
+
+	/* A block of the parallel TransPushDownRec, the
+	 * result covers the coefficients 0 to end
+	 */
+	template <class T> class TransPushDownTask : public Task {
+	public:
+		const Field<T>* F;
+		long end;
+		typename T::BigInt p;
+		vector<typename T::GFpX> W;
+		typename T::GFpX V;
+
+		void set(const Field<T>* K, const long e, const typename T::BigInt& c) {
+			F = K; end = e; p = c;
+			W.resize(p);
+		}
+		void run() {
+			F->switchContext();
+			TransPushDownRec<T>(W, V, 0, end, p, F);
+		}
+	};
+
+	template <class T> class TransposedMulTask;
+
 	/* The routine Transposed mul from Section 4
 	 * (step 2 of Lift-up)
 	 * Computes the transposed multiplication of the linear form
@@ -148,21 +249,42 @@ namespace FAAST {
 	 * by the element
 	 *     (W[0], ..., W[p-1])
 	 * modulo Q
+	 *
+	 * If F is given and more than one thread is available, the p
+	 * transposed products are computed concurrently in the context of F.
 	 */
 	template <class T> void TransposedMul(
 	vector<typename T::GFpX>& W, const typename T::GFpXModulus& Q,
-	const typename T::GFpX& form, const typename T::BigInt& p) {
+	const typename T::GFpX& form, const typename T::BigInt& p,
+	const Field<T>* F = NULL) {
 		typedef typename T::GFpX           GFpX;
 		typedef typename T::GFpXMultiplier GFpXMultiplier;
 		typedef typename T::BigInt         BigInt;
 
+		ProbeScope probe(PROBE_TRANSPOSEDMUL);
+		probe.coefficients(long(p) * deg(Q));
+		GFpX formtmp = -form;
+		if (F && getThreads() > 1 && deg(Q) >= getGrainSize()) {
+			vector<TransposedMulTask<T> > tasks; tasks.resize(p);
+			TaskGroup group;
+			tasks[long(p)-1].a = W[0] + W[long(p)-1];
+			for (BigInt i = 1; i < p ; i++)
+				tasks[long(p)-long(i)-1].a = W[i];
+			for (BigInt i = 0 ; i < p ; i++) {
+				tasks[i].set(F, W[i], formtmp, Q);
+				group.spawn(tasks[i]);
+			}
+			group.wait();
+			F->switchContext();
+			return;
+		}
+
 		vector<GFpXMultiplier> Trans; Trans.resize(p);
 
 		build(Trans[long(p)-1], W[0] + W[long(p)-1], Q);
 		for (BigInt i = 1; i < p ; i++)
 			build(Trans[long(p)-long(i)-1], W[i], Q);
 
-		GFpX formtmp = -form;
 		for (BigInt i = 0 ; i < p ; i++)
 			TransMulMod(W[i], formtmp, Trans[i], Q);
 	}
@@ -174,6 +296,8 @@ namespace FAAST {
 		typedef typename T::BigInt         BigInt;
 
 		long d = deg(Q);
+		ProbeScope probe(PROBE_TRANSMOD);
+		probe.coefficients((2*long(p) - 1) * d);
 		// Xn = X^d mod Q
 		GFpX Xn = -Q; SetCoeff(Xn, d, 0);
 		GFpXMultiplier Trans; build(Trans, Xn, Q);
@@ -189,7 +313,300 @@ namespace FAAST {
 		}
 	}
 
+	/* One of the p products of the parallel TransposedMul :
+	 * W = TransMulMod(form, a mod Q)
+	 */
+	template <class T> class TransposedMulTask : public Task {
+	public:
+		const Field<T>* F;
+		typename T::GFpX a;
+		typename T::GFpX* W;
+		const typename T::GFpX* form;
+		const typename T::GFpXModulus* Q;
+
+		void set(const Field<T>* K, typename T::GFpX& res,
+		const typename T::GFpX& f, const typename T::GFpXModulus& mod) {
+			F = K; W = &res; form = &f; Q = &mod;
+		}
+		void run() {
+			F->switchContext();
+			typename T::GFpXMultiplier Trans;
+			build(Trans, a, *Q);
+			TransMulMod(*W, *form, Trans, *Q);
+		}
+	};
+
+	/* One of the p branches of mod* and evaluate* in Lift-up */
+	template <class T> class TransModTask : public Task {
+	public:
+		const Field<T>* F;
+		typename T::GFpX* W;
+		const typename T::GFpXModulus* Q;
+		typename T::BigInt p;
+
+		void set(const Field<T>* K, typename T::GFpX& res,
+		const typename T::GFpXModulus& mod, const typename T::BigInt& c) {
+			F = K; W = &res; Q = &mod; p = c;
+		}
+		void run() {
+			F->switchContext();
+			TransMod<T>(*W, *Q, p);
+			contract<T>(*W, *W, 2*long(p) - 1);
+		}
+	};
+
+
+
+	/* The part of Push-down that only depends on the stem field
+	 * parent : built once, it can push down any number of elements.
+	 */
+	template <class T> class PushDownPlan {
+	public:
+		typedef typename T::GFpX   GFpX;
+		typedef typename T::BigInt BigInt;
+
+		const Field<T>* parent;
+		BigInt p;
+		/* the number of coefficients of each pushed down element */
+		long width;
+
+		/* parent must be a stem field with a subfield */
+		PushDownPlan(const Field<T>* stem) : parent(stem), p(stem->p) {
+			width = parent->subfield->d == 1 ? parent->d : long(p);
+		}
+
+		/* Push e[0], ..., e[n-1] down, the coefficients of e[i]
+		 * go to v[i*width], ..., v[i*width + width - 1].
+		 */
+		void run(const FieldElement<T>* e, const long n, FieldElement<T>* v) const {
+			const Field<T>* sub = parent->subfield;
+			bool base = sub->d == 1;
+			vector<GFpX> Ws; Ws.resize(n * width);
+			parent->switchContext();
+			for (long i = 0 ; i < n ; i++) {
+				if (!e[i].parent_field) continue;
+				const GFpX& eX = rep(e[i].repExt());
+				// if the subfield is prime
+				// simply take the list of coefficients
+				if (base) {
+					for (long j = 0 ; j <= deg(eX) ; j++)
+						Ws[i*width + j] = coeff(eX, j);
+					continue;
+				}
+				// the real push-down algorithm from Section 4
+				vector<GFpX> W;
+				pushDownRec<T>(eX, 0, deg(eX), W, p, parent);
+#if FAAST_DEBUG >= 2
+				for (BigInt j = 0 ; j < p ; j++) {
+					if (deg(W[j]) * p > deg(eX))
+						throw FAASTException("Problem in pushDownRec.");
+				}
+#endif
+				// if this extension was built modulo
+				//   X^p - X - x0 - 1
+				// the result lies in GF(p)[x0+1].
+				// This brings the elements back to GF(p)[x0]
+				if (parent->plusone) {
+					for (BigInt j = 0 ; j < p ; j++)
+						taylorShift<T>(W[j], W[j], 1, p);
+				}
+				// if this extension was built modulo
+				//   X^p - X - xi^(2p-1)
+				if (parent->twopminusone) {
+					for (BigInt j = 0 ; j < p ; j++)
+						expand<T>(W[j], W[j], 2*long(p) - 1);
+				}
+				for (BigInt j = 0 ; j < p ; j++)
+					swap(Ws[i*width + long(j)], W[j]);
+			}
+
+			// prepare to work in the subfield
+			sub->switchContext();
+
+			// convert the result of push-down-rec to elements
+			// of the subfield
+			for (long i = 0 ; i < n * width ; i++) {
+				v[i].setBase(base);
+				// this automatically reduces modulo
+				// the defining polynomial if needed
+				if (base) v[i].repBase() = coeff(Ws[i], 0);
+				else conv(v[i].repExt(), Ws[i]);
+				v[i].parent_field = sub;
+			}
+		}
+	};
+
+	/* The part of Lift-up that only depends on the stem field
+	 * parent : built once, it can lift up any number of elements.
+	 */
+	template <class T> class LiftUpPlan {
+	public:
+		typedef typename T::GFpX        GFpX;
+		typedef typename T::GFpE        GFpE;
+		typedef typename T::GFpXModulus GFpXModulus;
+		typedef typename T::BigInt      BigInt;
+
+		const Field<T>* parent;
+		BigInt p;
+		/* the number of coefficients of each lifted element */
+		long width;
+		/* the modulus of parent, shifted if needed */
+		const GFpXModulus* Q;
+		/* the trace form of Q */
+		const GFpX* trace;
+		/* the reverse of the modulus of the overfield */
+		GFpX revQQ;
+		long degQQ;
+		const FieldElement<T>* invDiffQQ;
+
+		/* parent must be a stem field with an overfield */
+		LiftUpPlan(const Field<T>* stem) : parent(stem), p(stem->p),
+		Q(NULL), trace(NULL), degQQ(0), invDiffQQ(NULL) {
+			width = parent->d == 1 ? parent->overfield->d : long(p);
+			if (parent->d == 1) return;
+
+			// the modulus and its trace form are cached by the stem
+			Q = &(parent->getLiftupModulus());
+			trace = &(parent->getTraceForm());
+
+			// the data of the overfield
+			invDiffQQ = &(parent->overfield->getLiftup());
+			parent->overfield->switchContext();
+			const GFpXModulus& QQ = GFpE::modulus();
+			degQQ = deg(QQ);
+			reverse(revQQ, QQ);
+		}
+
+		/* Lift up v[i*width], ..., v[i*width + width - 1] into e[i],
+		 * for 0 <= i < n.
+		 */
+		void run(const FieldElement<T>* v, const long n, FieldElement<T>* e) const {
+			const Field<T>* over = parent->overfield;
+			bool base = parent->d == 1;
+
+			// if this is a prime field
+			// simply merge the coefficients
+			if (base) {
+				vector<GFpX> eX; eX.resize(n);
+				parent->switchContext();
+				for (long i = 0 ; i < n ; i++) {
+					for (long j = width - 1 ; j >= 0 ; j--) {
+						if (!v[i*width + j].isZero())
+							SetCoeff(eX[i], j, v[i*width + j].repBase());
+					}
+				}
+				over->switchContext();
+				for (long i = 0 ; i < n ; i++) {
+					e[i].setBase(false);
+					conv(e[i].repExt(), eX[i]);
+					e[i].parent_field = over;
+				}
+				return;
+			}
+
+			// the real lift-up algorithm from Section 4
+			vector<GFpX> Vs; Vs.resize(n);
+			parent->switchContext();
+			for (long i = 0 ; i < n ; i++) {
+				// take the elements out of v
+				vector<GFpX> W; W.resize(p);
+				for (BigInt j = 0 ; j < p ; j++) {
+					const FieldElement<T>& c = v[i*width + long(j)];
+					if (!c.isZero()) W[j] = rep(c.repExt());
+				}
+				// The input lies in GF(p)[x0].
+				// If this extension was built modulo
+				//   X^p - X - x0 - 1
+				// the elements are brought into GF(p)[x0+1]
+				if (over->plusone) {
+					for (BigInt j = 0 ; j < p ; j++)
+						taylorShift<T>(W[j], W[j], -1, p);
+				}
 
+				// TransposedMul (step 2 of lift-up)
+				TransposedMul<T>(W, *Q, *trace, p, parent);
+
+				// if this extension was built modulo
+				//   X^p - X - xi^(2p-1)
+				// apply mod* and evaluate*
+				// (steps 2 and 3 of push-down*)
+				if (over->twopminusone) {
+					if (getThreads() > 1 && deg(*Q) >= getGrainSize()) {
+						vector<TransModTask<T> > tasks; tasks.resize(p);
+						TaskGroup group;
+						for (BigInt j = 0 ; j < p ; j++) {
+							tasks[j].set(parent, W[j], *Q, p);
+							group.spawn(tasks[j]);
+						}
+						group.wait();
+						parent->switchContext();
+					} else {
+						// mod*
+						for (BigInt j = 0 ; j < p ; j++)
+							TransMod<T>(W[j], *Q, p);
+						// evaluate*
+						for (BigInt j = 0 ; j < p ; j++)
+							contract<T>(W[j], W[j], 2*long(p) - 1);
+					}
+				}
+
+				// step 4 of push-down*
+				TransPushDownRec<T>(W, Vs[i], 0, over->d - 1, p, parent);
+			}
+
+			// now get ready to work in the overfield
+			over->switchContext();
+			ProbeScope probe(PROBE_LIFTUPMUL);
+			for (long i = 0 ; i < n ; i++) {
+				// step 4 of lift-up
+				MulTrunc(Vs[i], Vs[i], revQQ, degQQ);
+				// step 5 of lift-up
+				reverse(Vs[i], Vs[i], degQQ - 1);
+				e[i].setBase(false);
+				conv(e[i].repExt(), Vs[i]);
+				e[i].parent_field = over;
+				e[i] *= *invDiffQQ;
+			}
+		}
+	};
+
+	/* A slice of a batch, run by a task : P is one of the plans */
+	template <class T, class P> class BatchTask : public Task {
+	public:
+		const P* plan;
+		const FieldElement<T>* in;
+		long n;
+		FieldElement<T>* out;
+
+		void run() { plan->run(in, n, out); }
+	};
+
+	/* Run plan on n elements, splitting them among the threads.
+	 * Element i reads inw elements from in and writes outw
+	 * elements to out.
+	 */
+	template <class T, class P> void runBatch(const P& plan,
+	const FieldElement<T>* in, const long inw, const long n,
+	FieldElement<T>* out, const long outw) {
+		const long slices = min(getThreads(), n);
+		if (slices <= 1) {
+			plan.run(in, n, out);
+			return;
+		}
+		vector<BatchTask<T,P> > tasks; tasks.resize(slices);
+		TaskGroup group;
+		long start = 0;
+		for (long i = 0 ; i < slices ; i++) {
+			long size = n / slices + (i < n % slices ? 1 : 0);
+			tasks[i].plan = &plan;
+			tasks[i].in = in + start*inw;
+			tasks[i].n = size;
+			tasks[i].out = out + start*outw;
+			group.spawn(tasks[i]);
+			start += size;
+		}
+		group.wait();
+	}
 
 	/* Push the element e down along the stem and store
 	 * the result in v.
@@ -201,7 +618,6 @@ namespace FAAST {
 	throw(NoSubFieldException) {
 		typedef typename T::GFp    GFp;
 		typedef typename T::GFpX   GFpX;
-		typedef typename T::BigInt BigInt;
 
 		if (!e.parent_field) {
 			v.clear();
@@ -216,74 +632,29 @@ namespace FAAST {
 		// if the subfield is prime
 		// simply return the list of coefficients
 		if (parent->subfield->d == 1) {
-			v.resize(deg(rep(e.repExt)) + 1);
+			v.resize(deg(rep(e.repExt())) + 1);
 			const Field<T>* base = &(parent->primeField());
-			const GFpX& eX = rep(e.repExt);
+			const GFpX& eX = rep(e.repExt());
 			for (long i = 0 ; i <= deg(eX) ; i++) {
-				v[i].base = true;
-				v[i].repExt = 0;
-				v[i].repBase = coeff(eX, i);
+				v[i].setBase(true);
+				v[i].repBase() = coeff(eX, i);
 				v[i].parent_field = base;
 			}
 		}
 		// if the element is a scalar
-		else if (deg(rep(e.repExt)) <= 0) {
+		else if (deg(rep(e.repExt())) <= 0) {
 			v.resize(1);
-			v[0].base = false;
-			v[0].repBase = 0;
-			GFp ec = coeff(rep(e.repExt), 0);
+			v[0].setBase(false);
+			GFp ec = coeff(rep(e.repExt()), 0);
 			parent->subfield->switchContext();
-			v[0].repExt = ec;
+			v[0].repExt() = ec;
 			v[0].parent_field = parent->subfield;
 		}
 		// the real push-down algorithm from Section 4
 		else {
-			vector<GFpX> W;
-			BigInt p = parent->p;
-			pushDownRec<T>(rep(e.repExt), 0, deg(rep(e.repExt)), W, p);
-#if FAAST_DEBUG >= 2
-			for (BigInt i = 0 ; i < p ; i++) {
-				if (deg(W[i]) * p > deg(rep(e.repExt)))
-					throw FAASTException("Problem in pushDownRec.");
-			}
-#endif
-			// if this extension was built modulo
-			//   X^p - X - x0 - 1
-			// the result lies in GF(p)[x0+1].
-			// This brings the elements back to GF(p)[x0]
-			if (parent->plusone) {
-				GFpX xplusone;
-				SetCoeff(xplusone, 1); SetCoeff(xplusone, 0);
-				for (BigInt i = 0 ; i < p ; i++)
-					compose<T>(W[i], W[i], xplusone, p);
-			}
-			// if this extension was built modulo
-			//   X^p - X - xi^(2p-1)
-			if (parent->twopminusone) {
-				for (BigInt i = 0 ; i < p ; i++)
-					expand<T>(W[i], W[i], 2*long(p) - 1);
-			}
-
-			// prepare to work in the subfield
-			parent->subfield->switchContext();
-
-			// convert the result of push-down-rec to elements
-			// of the subfield
-			v.resize(p);
-			bool base = parent->subfield->d == 1;
-			for (BigInt i = 0 ; i < p ; i++) {
-				v[i].base = base;
-				// this automatically reduces modulo
-				// the defining polynomial if needed
-				if (base) {
-					v[i].repExt = 0;
-					v[i].repBase = coeff(W[i], 0);
-				} else {
-					v[i].repBase = 0;
-					conv(v[i].repExt, W[i]);
-				}
-				v[i].parent_field = parent->subfield;
-			}
+			PushDownPlan<T> plan(parent);
+			v.resize(plan.width);
+			plan.run(&e, 1, &v[0]);
 		}
 	}
 
@@ -302,9 +673,6 @@ namespace FAAST {
 	throw(NotInSameFieldException, NoOverFieldException) {
 		typedef typename T::GFp    GFp;
 		typedef typename T::GFpX        GFpX;
-		typedef typename T::GFpE        GFpE;
-		typedef typename T::GFpXModulus GFpXModulus;
-		typedef typename T::BigInt      BigInt;
 
 		// if v is empty, return the generic 0
 		typename vector<FieldElement<T> >::const_iterator it = v.begin();
@@ -316,7 +684,7 @@ namespace FAAST {
 		// and save this field into parent.
 		// In parallel, check if v represents a scalar
 		const Field<T>* parent = it->parent_field;
-		bool scalar = it->base || deg(rep(it->repExt)) <= 0;
+		bool scalar = it->base || deg(rep(it->repExt())) <= 0;
 		for (it++ ; it != v.end() ; it++) {
 			if (!parent) parent = it->parent_field;
 			else if (it->parent_field && it->parent_field != parent)
@@ -339,100 +707,69 @@ namespace FAAST {
 			GFpX eX;
 			for (long i = min(parent->overfield->d, long(v.size())) - 1 ; i >=0 ; i--) {
 				if (!v[i].isZero())
-					SetCoeff(eX, i, v[i].repBase);
+					SetCoeff(eX, i, v[i].repBase());
 			}
 			parent->overfield->switchContext();
-			e.base = false;
-			e.repBase = 0;
-			conv(e.repExt, eX);
+			e.setBase(false);
+			conv(e.repExt(), eX);
 			e.parent_field = parent->overfield;
 		}
 		// if the element is a scalar
 		else if (scalar) {
-			e.base = false;
-			e.repBase = 0;
-			GFp ec = coeff(rep(v[0].repExt), 0);
+			GFp ec;
+			if (v[0].parent_field) ec = coeff(rep(v[0].repExt()), 0);
+			e.setBase(false);
 			parent->overfield->switchContext();
-			e.repExt = ec;
+			e.repExt() = ec;
 			e.parent_field = parent->overfield;
 		}
 		// the real lift-up algorithm from Section 4
 		else {
-			bool base = parent->d == 1;
-			BigInt p = parent->p;
-			GFpXModulus Q = GFpE::modulus();
-
-			// take the elements out of v
-			vector<GFpX> W; W.resize(p);
-			for (BigInt i = 0 ; i < p ; i++) {
-				if (i < long(v.size()) && !v[i].isZero()) {
-					if (base) W[i] = v[i].repBase;
-					else W[i] = rep(v[i].repExt);
-				}
-			}
-			// The input lies in GF(p)[x0].
-			// If this extension was built modulo
-			//   X^p - X - x0 - 1
-			// this brings the elements into GF(p)[x0+1]
-			if (parent->overfield->plusone) {
-				GFpX xminusone;
-				SetCoeff(xminusone, 1); SetCoeff(xminusone, 0, -1);
-				for (BigInt i = 0 ; i < p ; i++)
-					compose<T>(W[i], W[i], xminusone, p);
-				GFpX tmp;
-				compose<T>(tmp, Q.val(), xminusone, p);
-				build(Q, tmp);
-			}
-
-			// get the trace form
-			if (Q.tracevec.length() == 0) {
-#ifdef FAAST_TIMINGS
-				Field<T>::TIME.TRACEVEC = -GetTime();
-#endif
-				ComputeTraceVec(Q);
-#ifdef FAAST_TIMINGS
-				Field<T>::TIME.TRACEVEC += GetTime();
-#endif
-			}
-			GFpX trace; conv(trace, Q.tracevec);
-			// TransposedMul (step 2 of lift-up)
-			TransposedMul<T>(W, Q, trace, p);
-
-			// if this extension was built modulo
-			//   X^p - X - xi^(2p-1)
-			// apply mod* and evaluate*
-			// (steps 2 and 3 of push-down*)
-			if (parent->overfield->twopminusone) {
-				// mod*
-				for (BigInt i = 0 ; i < p ; i++)
-					TransMod<T>(W[i], Q, p);
-				// evaluate*
-				for (BigInt i = 0 ; i < p ; i++)
-					contract<T>(W[i], W[i], 2*long(p) - 1);
+			LiftUpPlan<T> plan(parent);
+			if (long(v.size()) >= plan.width) {
+				plan.run(&v[0], 1, &e);
+			} else {
+				vector<FieldElement<T> > padded(v);
+				padded.resize(plan.width);
+				plan.run(&padded[0], 1, &e);
 			}
+		}
+	}
 
-			// step 4 of push-down*
-			GFpX V;
-			TransPushDownRec<T>(W, V, 0, parent->overfield->d - 1, p);
+	/* Push down n elements of K at once */
+	template <class T>
+	void pushDownBatch(const Field<T>& K, const FieldElement<T>* e,
+	const long n, FieldElement<T>* v)
+	throw(NoSubFieldException, NotInSameFieldException) {
+		const Field<T>* parent = K.stem;
+		if (!parent->subfield)
+			throw NoSubFieldException();
+		for (long i = 0 ; i < n ; i++) {
+			if (e[i].parent_field && e[i].parent_field->stem != parent)
+				throw NotInSameFieldException();
+		}
+		if (n <= 0) return;
 
-			// now get ready to work in the overfield
-			parent->overfield->switchContext();
+		PushDownPlan<T> plan(parent);
+		runBatch<T>(plan, e, 1, n, v, plan.width);
+	}
 
-			// step 4 of lift-up
-			const GFpXModulus& QQ = GFpE::modulus();
-			GFpX revQ; reverse(revQ, QQ);
-			MulTrunc(V, V, revQ, deg(QQ));
-
-			// step 5 of lift-up
-			reverse(V, V, deg(QQ) - 1);
-			e.base = false;
-			e.repBase = 0;
-			conv(e.repExt, V);
-			e.parent_field = parent->overfield;
-			const FieldElement<T>& invDiffQQ =
-				parent->overfield->getLiftup();
-			e *= invDiffQQ;
+	/* Lift up n elements of K.overField() at once */
+	template <class T>
+	void liftUpBatch(const Field<T>& K, const FieldElement<T>* v,
+	const long n, FieldElement<T>* e)
+	throw(NotInSameFieldException, NoOverFieldException) {
+		const Field<T>* parent = K.stem;
+		if (!parent->overfield)
+			throw NoOverFieldException();
+		if (n <= 0) return;
+
+		LiftUpPlan<T> plan(parent);
+		for (long i = 0 ; i < n * plan.width ; i++) {
+			if (v[i].parent_field && v[i].parent_field->stem != parent)
+				throw NotInSameFieldException();
 		}
+		runBatch<T>(plan, v, plan.width, n, e, 1);
 	}
 
 }
@@ -20,6 +20,7 @@
 	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #import "FAAST/utilities.hpp"
+#import <algorithm>
 #ifdef FAAST_DEBUG
 #import <string>
 #import <sstream>
@@ -47,8 +48,7 @@ namespace FAAST {
 		n /= smalld;
 		long j = 0;
 		while (n != 0) {
-			const long c = n % p;
-			for (long i = 0 ; i < c ; i++) BigFrob(j);
+			BigFrobPow(j, n % p);
 			n /= p ; j++;
 		}
 	}
@@ -119,16 +119,11 @@ namespace FAAST {
 				const long c = n / power_long(p, i);
 				if (c == 0) {
 					v[i] = 0;
-				} else if (c > 1) {
-					FieldElement<T> t = v[i];
-					for (long h = 1 ; h < c ; h++) {
-						t.BigFrob(i);
-						v[i] += t;
-					}
+				} else {
+					v[i].BigPTraceStep(i, c);
 				}
 				if (i < j-1) {
-					for (long h = 0 ; h < c ; h++)
-						v[i+1].BigFrob(i);
+					v[i+1].BigFrobPow(i, c);
 					v[i] += v[i+1];
 				}
 				n %= power_long(p, i);
@@ -146,37 +141,69 @@ namespace FAAST {
 /****************** Helpers for frobenius and trace ******************/
 	/* See Section 5 and the long version (probably section 6). */
 
-	/* p^j-th iterated frobenius */
-	template <class T> void FieldElement<T>::BigFrob(const long j) {
+	/* Frobenius of one of the components in BigFrob */
+	template <class T> class FieldElement<T>::BigFrobTask : public Task {
+	public:
+		FieldElement<T>* e;
+		long j, i;
+
+		void run() {
+			if (e->parent_field) e->parent_field->switchContext();
+			e->BigFrob(j, i);
+		}
+	};
+
+	/* (2^i p^j)-th iterated frobenius. The p components are independent,
+	 * they are processed concurrently on high enough fields.
+	 * The (2^i p^j d)-th frobenius of x_h is x_h plus the (2^i p^j d)-th
+	 * pseudotrace of alpha, so the algorithm is the same for any i.
+	 */
+	template <class T> void FieldElement<T>::BigFrob(const long j, const long i) {
 #ifdef FAAST_DEBUG
-		if (j < 0 || j >= parent_field->height) {
+		if (j < 0 || j >= parent_field->height
+		    || i < 0 || i >= NumBits(parent_field->p)) {
 			stringstream msg;
-			msg << "Bad input to BigFrob : " << j << ".";
+			msg << "Bad input to BigFrob : " << j << ", " << i << ".";
 			throw FAASTException(msg.str().c_str());
 		}
 #endif
 		if (isScalar()) return;
 
+		ProbeScope probe(PROBE_BIGFROB);
+		probe.coefficients(2 * parent_field->d);
 		BigInt p = parent_field->p;
 		// step 2
 		vector<FieldElement<T> > down;
 		FAAST::pushDown(*this, down);
 		down.resize(p);
+		// step 5 needs beta, fetch it before forking
+		const FieldElement<T>& beta = parent_field->getPseudotrace(j, i);
 		// step 3
 		if (j < parent_field->height - 1) {
-			for (BigInt i = 0 ; i < p ; i++)
-			down[i].BigFrob(j);
+			if (getThreads() > 1 && parent_field->height >= getParallelHeight()) {
+				vector<BigFrobTask> tasks; tasks.resize(p);
+				TaskGroup group;
+				for (BigInt k = 0 ; k < p ; k++) {
+					tasks[k].e = &down[k];
+					tasks[k].j = j;
+					tasks[k].i = i;
+					group.spawn(tasks[k]);
+				}
+				group.wait();
+			} else {
+				for (BigInt k = 0 ; k < p ; k++)
+				down[k].BigFrob(j, i);
+			}
 		}
 		// step 5
-		const FieldElement<T>& beta = parent_field->getPseudotrace(j);
 		vector<FieldElement<T> > result;
 		result.resize(p);
-		for (BigInt i = 0 ; i < p ; i++) {
-			result[i] = down[long(p)-1];
-			for (long j = long(i) - 1 ; j >= 0 ; j--) {
-				result[j] *= beta;
-				if (j > 0) result[j] += result[j-1];
-				else result[j] += down[long(p)-long(i)-1];
+		for (BigInt k = 0 ; k < p ; k++) {
+			result[k] = down[long(p)-1];
+			for (long h = long(k) - 1 ; h >= 0 ; h--) {
+				result[h] *= beta;
+				if (h > 0) result[h] += result[h-1];
+				else result[h] += down[long(p)-long(k)-1];
 			}
 		}
 		// step 6
@@ -185,6 +212,41 @@ namespace FAAST {
 		parent_field = parent;
 	}
 
+	/* (c p^j)-th iterated frobenius, c < p */
+	template <class T> void FieldElement<T>::BigFrobPow(const long j, const long c) {
+		for (long i = 0 ; (c >> i) != 0 ; i++)
+			if ((c >> i) & 1) BigFrob(j, i);
+	}
+
+	/* Sum of the c first conjugates under the (p^j d)-th frobenius.
+	 * t is the sum of the first 2^i conjugates, acc the sum of the
+	 * first m conjugates, m being the lower i bits of c. Then
+	 *   sum_(k < 2^i + m) = t + frob^(2^i)(acc)
+	 */
+	template <class T> void FieldElement<T>::BigPTraceStep(const long j, const long c) {
+		if (isZero() || c == 1) return;
+
+		FieldElement<T> t = *this, acc, tmp;
+		bool first = true;
+		for (long i = 0 ; (c >> i) != 0 ; i++) {
+			if ((c >> i) & 1) {
+				if (first) {
+					acc = t;
+					first = false;
+				} else {
+					acc.BigFrob(j, i);
+					acc += t;
+				}
+			}
+			if ((c >> (i+1)) != 0) {
+				tmp = t;
+				tmp.BigFrob(j, i);
+				t += tmp;
+			}
+		}
+		*this = acc;
+	}
+
 	/* n-th iterated frobenius, n < d */
 	template <class T> void FieldElement<T>::SmallFrob(const long n) {
 #ifdef FAAST_DEBUG
@@ -196,6 +258,20 @@ namespace FAAST {
 #endif
 		if (isScalar()) return;
 
+		if (parent_field->useFrobeniusTable(n)) {
+			typedef typename T::GFpXArgument GFpXArgument;
+			const vector<GFpXArgument>& table = parent_field->getFrobeniusTable();
+			parent_field->switchContext();
+			const typename T::GFpXModulus& P = GFpE::modulus();
+			// compose with X^(p^(2^i)) for each bit i of n
+			GFpX a = rep(repExt());
+			long m = n;
+			for (long i = 0 ; m != 0 ; i++, m >>= 1)
+				if (m & 1) CompMod(a, a, table[i], P);
+			conv(repExt(), a);
+			return;
+		}
+
 		for (long i = 0 ; i < n ; i++)
 			self_frobenius();
 	}
@@ -212,13 +288,8 @@ namespace FAAST {
 		if (isZero()) return;
 
 		SmallPTrace(parent_field->baseField().d);
-		for (long i = 1 ; i <= j ; i++) {
-			FieldElement<T> t = *this;
-			for (BigInt h = 1 ; h < parent_field->p ; h++) {
-				t.BigFrob(i-1);
-				*this += t;
-			}
-		}
+		for (long i = 1 ; i <= j ; i++)
+			BigPTraceStep(i-1, parent_field->p);
 	}
 
 	/* Put in the vector v all the p^id pseudotraces for 0 <= i <= j */
@@ -237,11 +308,7 @@ namespace FAAST {
 		v[0].SmallPTrace(parent_field->baseField().d);
 		for (long i = 1 ; i <= j ; i++) {
 			v[i] = v[i-1];
-			FieldElement<T> t = v[i];
-			for (BigInt h = 1 ; h < parent_field->p ; h++) {
-				t.BigFrob(i-1);
-				v[i] += t;
-			}
+			v[i].BigPTraceStep(i-1, parent_field->p);
 		}
 	}
 
@@ -258,6 +325,32 @@ namespace FAAST {
 
 		if (n == 0) {
 			*this = parent_field->zero();
+		} else if (parent_field->useFrobeniusTable(n)) {
+			typedef typename T::GFpXArgument GFpXArgument;
+			const vector<GFpXArgument>& table = parent_field->getFrobeniusTable();
+			parent_field->switchContext();
+			const typename T::GFpXModulus& P = GFpE::modulus();
+			// t is the sum of the first 2^i conjugates, acc the
+			// sum of the first c conjugates, c being the lower
+			// i bits of n. Then
+			//   sum_(k < 2^i + c) = t + frob^(2^i)(acc)
+			GFpX t = rep(repExt()), acc, tmp;
+			bool first = true;
+			long m = n;
+			for (long i = 0 ; m != 0 ; i++, m >>= 1) {
+				if (m & 1) {
+					if (first) { acc = t; first = false; }
+					else {
+						CompMod(tmp, acc, table[i], P);
+						add(acc, t, tmp);
+					}
+				}
+				if (m > 1) {
+					CompMod(tmp, t, table[i], P);
+					add(t, t, tmp);
+				}
+			}
+			conv(repExt(), acc);
 		} else {
 			FieldElement<T> t(*this);
 			for (long i = 1 ; i < n ; i++) {
@@ -267,4 +360,203 @@ namespace FAAST {
 		}
 	}
 
+/****************** Exponentiation ******************/
+	/* The L lowest base-p digits of e, the lowest first. The two halves
+	 * of e are split recursively, so that the cost is quasi-linear.
+	 */
+	void baseDigits(long* dig, const ZZ& e, const long p, const long L) {
+		if (L <= 16) {
+			ZZ q = e;
+			for (long i = 0 ; i < L ; i++) dig[i] = DivRem(q, q, p);
+			return;
+		}
+		const long h = L / 2;
+		ZZ ph, q, r;
+		power(ph, p, h);
+		DivRem(q, r, e, ph);
+		baseDigits(dig, r, p, h);
+		baseDigits(dig + h, q, p, L - h);
+	}
+
+	/* Rough cost of self_frobenius(n), in multiplications. In towers,
+	 * the small part is made of p-th powers. A BigFrob at level j goes
+	 * down h-j levels, each costing a push-down, a lift-up and p
+	 * products in the subfield.
+	 */
+	template <class T> double FieldElement<T>::FrobCost(long n) const {
+		const Field<T>* K = parent_field;
+		n %= K->d;
+		if (n == 0) return 0;
+		const long p = long(K->p);
+		const long smalld = K->baseField().d, h = K->height;
+		const long r = n % smalld;
+		double cost = 0;
+		if (r != 0) {
+			if (K->useFrobeniusTable(r))
+				cost = 2.0 * weight(r) * SqrRoot(smalld);
+			else
+				cost = 1.25 * r * NumBits(p);
+		}
+		n /= smalld;
+		for (long j = 0 ; n != 0 ; j++, n /= p)
+			cost += double(weight(n % p)) * (h - j) * (h + p);
+		return cost;
+	}
+
+	/* Rough cost of HornerFrob : one frobenius and one product per
+	 * nonzero digit.
+	 */
+	template <class T> double FieldElement<T>::HornerFrobCost(
+	const long* dig, const long len) const {
+		double cost = 0;
+		long last = -1;
+		for (long t = len - 1 ; t >= 0 ; t--) {
+			if (dig[t] == 0) continue;
+			if (last >= 0) cost += FrobCost(last - t) + 1;
+			last = t;
+		}
+		if (last > 0) cost += FrobCost(last);
+		return cost;
+	}
+
+	/* this = x^(sum dig[t] p^t) by Horner's rule, where x is this
+	 * element and powers[i] = x^digits[i].
+	 */
+	template <class T> void FieldElement<T>::HornerFrob(const long* dig,
+	const long len, const vector<long>& digits,
+	const vector<FieldElement<T> >& powers) {
+		const Field<T>* K = parent_field;
+		FieldElement<T> res = K->one();
+		long last = -1;
+		for (long t = len - 1 ; t >= 0 ; t--) {
+			if (dig[t] == 0) continue;
+			const long i = lower_bound(digits.begin(), digits.end(), dig[t])
+				- digits.begin();
+			if (last >= 0) {
+				res.self_frobenius(last - t);
+				res *= powers[i];
+			} else res = powers[i];
+			last = t;
+		}
+		if (last > 0) res.self_frobenius(last);
+		*this = res;
+	}
+
+	/* this^e, for e > 0, using the frobenius. With m the smallest
+	 * period of the base-p digits of e, computed by the prefix function,
+	 *	e = B (1 + p^m + ... + p^((k-1)m)) + C p^(km)
+	 * with C < p^m. The power x^B is computed by HornerFrob, then
+	 * raised to the repunit by doubling, as in Itoh-Tsujii,
+	 *	y_(2i) = y_i frob^(im)(y_i),	y_(i+1) = frob^m(y_i) y_1,
+	 * and x^C, whose digits are the lowest of B, by HornerFrob again.
+	 * Returns false if the plain square-and-multiply, costing about
+	 * 5/4 multiplications per bit of e, is estimated cheaper.
+	 */
+	template <class T> bool FieldElement<T>::FrobPower(const ZZ& i) {
+		const Field<T>* K = parent_field;
+		if (NumBits(K->p) >= NTL_BITS_PER_LONG - 1) return false;
+		const long p = long(K->p);
+		const long bits = NumBits(p) - 1;
+		// x^(q-1) = 1
+		ZZ e = i;
+		if (NumBits(e) > K->d * bits) {
+			ZZ q;
+			power(q, p, K->d);
+			q -= 1;
+			rem(e, e, q);
+		}
+		const double plain = 1.25 * NumBits(e);
+		// any frobenius is about as expensive as the first one
+		if (IsZero(e) || plain <= FrobCost(1)) return false;
+
+		long L = NumBits(e) / bits + 1;
+		vector<long> dig; dig.resize(L);
+		baseDigits(&dig[0], e, p, L);
+		while (dig[L-1] == 0) L--;
+		vector<long> prefix; prefix.resize(L);
+		for (long t = 1 ; t < L ; t++) {
+			long j = prefix[t-1];
+			while (j > 0 && dig[t] != dig[j]) j = prefix[j-1];
+			prefix[t] = dig[t] == dig[j] ? j + 1 : j;
+		}
+		const long m = L - prefix[L-1], k = L / m, c = L - k*m;
+
+		// the nonzero digits and the cost of their powers
+		vector<long> digits(dig.begin(), dig.begin() + m);
+		sort(digits.begin(), digits.end());
+		digits.erase(unique(digits.begin(), digits.end()), digits.end());
+		if (digits[0] == 0) digits.erase(digits.begin());
+		double cost = 0;
+		for (long j = 0 ; j < long(digits.size()) ; j++)
+			cost += 1.25 * NumBits(digits[j] - (j ? digits[j-1] : 0)) + 1;
+		// Horner's rule and repunit
+		cost += HornerFrobCost(&dig[0], m);
+		for (long b = NumBits(k) - 2, n = 1 ; b >= 0 ; b--) {
+			cost += FrobCost(n*m) + 1;
+			n *= 2;
+			if (bit(k, b)) { cost += FrobCost(m) + 1; n++; }
+		}
+		if (c > 0) cost += HornerFrobCost(&dig[0], c) + FrobCost(k*m) + 1;
+		if (cost >= plain) return false;
+
+		vector<FieldElement<T> > powers; powers.resize(digits.size());
+		for (long j = 0 ; j < long(digits.size()) ; j++) {
+			if (j == 0) powers[j] = *this ^ digits[j];
+			else powers[j] = powers[j-1] * (*this ^ (digits[j] - digits[j-1]));
+		}
+		FieldElement<T> y = *this, z, tmp;
+		y.HornerFrob(&dig[0], m, digits, powers);
+		z = y;
+		for (long b = NumBits(k) - 2, n = 1 ; b >= 0 ; b--) {
+			tmp = z;
+			tmp.self_frobenius(n*m);
+			z *= tmp;
+			n *= 2;
+			if (bit(k, b)) {
+				z.self_frobenius(m);
+				z *= y;
+				n++;
+			}
+		}
+		if (c > 0) {
+			tmp = *this;
+			tmp.HornerFrob(&dig[0], c, digits, powers);
+			tmp.self_frobenius(k*m);
+			z *= tmp;
+		}
+		*this = z;
+		return true;
+	}
+
+
+	/* Inversion in the style of Itoh-Tsujii. With r = (p^D-1)/(p-1),
+	 *	x^(r-1) = frob(x^(1 + p + ... + p^(D-2)))
+	 * the repunit being computed by doubling, as in FrobPower. Then
+	 * x^r is the norm of x to GF(p), a constant, and
+	 *	1/x = x^(r-1) / x^r.
+	 */
+	template <class T> void FieldElement<T>::ItohTsujiiInv() {
+		const long k = parent_field->d - 1;
+		FieldElement<T> y = *this, tmp;
+		for (long b = NumBits(k) - 2, n = 1 ; b >= 0 ; b--) {
+			tmp = y;
+			tmp.self_frobenius(n);
+			y *= tmp;
+			n *= 2;
+			if (bit(k, b)) {
+				y.self_frobenius(1);
+				y *= *this;
+				n++;
+			}
+		}
+		y.self_frobenius(1);
+		tmp = y * (*this);
+
+		parent_field->switchContext();
+		GFp norm = ConstTerm(rep(tmp.repExt()));
+		NTL::inv(norm, norm);
+		repExt() = y.repExt();
+		repExt() *= norm;
+	}
+
 }
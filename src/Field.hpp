@@ -26,10 +26,8 @@
 #include <sstream>
 
 namespace FAAST {
-/****************** Timings ******************/
-#ifdef FAAST_TIMINGS
-	template <class T> TIMINGS Field<T>::TIME;
-#endif
+/****************** Contexts ******************/
+	template <class T> ThreadLocal<typename Field<T>::ContextState> Field<T>::current;
 /****************** Constructors ******************/
 	/* All constructors are static. There's no way to directly
 	 * create a Field object. Field objects are permanent and
@@ -54,25 +52,19 @@ namespace FAAST {
 		long d = deg(P);
 		Context context; context.p.save(); context.P.save();
 		// test primality
-#ifdef FAAST_TIMINGS
-		TIME.PRIMETEST = -GetTime();
-#endif
-		if ( p <= long(1) || (test && !ProbPrime(p)) ) {
-			throw NotPrimeException();
+		{
+			ProbeScope probe(PROBE_PRIMETEST);
+			if ( p <= long(1) || (test && !ProbPrime(p)) ) {
+				throw NotPrimeException();
+			}
 		}
-#ifdef FAAST_TIMINGS
-		TIME.PRIMETEST += GetTime();
-#endif
 		// test irreducibility
-#ifdef FAAST_TIMINGS
-		TIME.IRREDTEST = -GetTime();
-#endif
-		if (d > 1 && test && !DetIrredTest(P)) {
-			throw NotIrreducibleException();
+		{
+			ProbeScope probe(PROBE_IRREDTEST);
+			if (d > 1 && test && !DetIrredTest(P)) {
+				throw NotIrreducibleException();
+			}
 		}
-#ifdef FAAST_TIMINGS
-		TIME.IRREDTEST += GetTime();
-#endif
 		// build GF(p^d)
 		if (d >= 2) {
 			// build GF(p)
@@ -102,15 +94,12 @@ namespace FAAST {
 		long d = deg(P);
 		Context context; context.P.save();
 		// test irreducibility
-#ifdef FAAST_TIMINGS
-		TIME.IRREDTEST = -GetTime();
-#endif
-		if (d > 1 && test && !IterIrredTest(P)) {
-			throw NotIrreducibleException();
+		{
+			ProbeScope probe(PROBE_IRREDTEST);
+			if (d > 1 && test && !IterIrredTest(P)) {
+				throw NotIrreducibleException();
+			}
 		}
-#ifdef FAAST_TIMINGS
-		TIME.IRREDTEST += GetTime();
-#endif
 
 		// build GF(p^d)
 		if (d >= 2) {
@@ -171,26 +160,21 @@ namespace FAAST {
 		if (p <= long(1)) {
 			throw NotPrimeException();
 		}
-#ifdef FAAST_TIMINGS
-		TIME.PRIMETEST = -GetTime();
-#endif
-		if (test && !ProbPrime(p)) {
-			throw NotPrimeException();
+		{
+			ProbeScope probe(PROBE_PRIMETEST);
+			if (test && !ProbPrime(p)) {
+				throw NotPrimeException();
+			}
 		}
-#ifdef FAAST_TIMINGS
-		TIME.PRIMETEST += GetTime();
-#endif
 
 		GFp::init(p);
 		GFpX P;
-#ifdef FAAST_TIMINGS
-		TIME.BUILDIRRED = -GetTime();
-#endif
-		if (d >= 2) BuildIrred(P, d);
-		else SetX(P);
-#ifdef FAAST_TIMINGS
-		TIME.BUILDIRRED += GetTime();
-#endif
+		{
+			ProbeScope probe(PROBE_BUILDIRRED);
+			if (d >= 2) BuildIrred(P, d);
+			else SetX(P);
+			probe.coefficients(d + 1);
+		}
 		return createField(P, false);
 	}
 
@@ -207,14 +191,12 @@ namespace FAAST {
 		}
 
 		GFpX P;
-#ifdef FAAST_TIMINGS
-		TIME.BUILDIRRED = -GetTime();
-#endif
-		if (d >= 2) BuildIrred(P, d);
-		else SetX(P);
-#ifdef FAAST_TIMINGS
-		TIME.BUILDIRRED += GetTime();
-#endif
+		{
+			ProbeScope probe(PROBE_BUILDIRRED);
+			if (d >= 2) BuildIrred(P, d);
+			else SetX(P);
+			probe.coefficients(d + 1);
+		}
 		return createField(P, false);
 	}
 
@@ -320,13 +302,35 @@ namespace FAAST {
 		return FieldPolynomial<T>(this, x);
 	}
 
-	/* Set the context to work in this field */
+	/* Set the context to work in this field.
+	 *
+	 * The restore is skipped if this thread has already installed the
+	 * context of the stem and NTL's moduli are still the same. A stem
+	 * keeps its moduli alive, so no other modulus can take their address.
+	 */
 	template<class T> void Field<T>::switchContext() const throw() {
+		ContextState& state = current.get();
+		if (state.stem == stem && state.modulus == &GFpE::modulus()
+		    && GFp::modulus() == stem->p) {
+			state.switches.skipped++;
+			return;
+		}
 		stem->context.p.restore();
 		stem->context.P.restore();
+		state.stem = stem;
+		state.modulus = &GFpE::modulus();
+		state.switches.restored++;
 	}
 	template<> void Field<GF2_Algebra>::switchContext() const throw() {
+		ContextState& state = current.get();
+		if (state.stem == stem && state.modulus == &GFpE::modulus()) {
+			state.switches.skipped++;
+			return;
+		}
 		stem->context.P.restore();
+		state.stem = stem;
+		state.modulus = &GFpE::modulus();
+		state.switches.restored++;
 	}
 
 /****************** Field lattice navigation ******************/
@@ -27,19 +27,58 @@
 
 namespace FAAST {
 
+	/* Balanced product of factors[lo], ..., factors[hi-1] of
+	 * cantor89, stored in factors[lo]. If F is given, the two
+	 * halves of big enough products are computed concurrently,
+	 * the spawned half installing the cyclotomic context.
+	 */
+	template <class T> class CantorProductTask : public Task {
+	public:
+		vector<typename T::GFpEX>* factors;
+		long lo, hi;
+		const Field<T>* F;
+		bool restore;
+
+		CantorProductTask(vector<typename T::GFpEX>* f, const long l,
+		const long h, const Field<T>* K, const bool r = false)
+		: factors(f), lo(l), hi(h), F(K), restore(r) {}
+
+		void run() {
+			if (hi - lo <= 1) return;
+			if (restore) {
+				F->switchContext();
+				F->primeField().getCyclotomic().P.restore();
+			}
+			const long mid = (lo + hi) / 2;
+			CantorProductTask<T> left(factors, lo, mid, F);
+			CantorProductTask<T> right(factors, mid, hi, F, true);
+			if (F && getThreads() > 1 &&
+				(hi - lo) * (deg((*factors)[lo]) + 1) >= getGrainSize()) {
+				forkJoin(left, right);
+			} else {
+				right.restore = false;
+				left.run(); right.run();
+			}
+			(*factors)[lo] *= (*factors)[mid];
+		}
+	};
+
 	/* Cantor's algorithm to compute the minimal polynomial
 	 * of the primitive generator of the Artin-Schreier
 	 * extension.
 	 *
 	 * It assumes the modulus has already been properly set
-	 * to the (2p-1)th cyclotomic polynomial.
+	 * to the (2p-1)th cyclotomic polynomial. If F is given, the
+	 * subproduct tree is computed in parallel.
 	 */
 	template <class T> void cantor89(typename T::GFpX& res,
-	const typename T::GFpX& Q, const long p) {
+	const typename T::GFpX& Q, const long p, const Field<T>* F = NULL) {
 		typedef typename T::GFpX  GFpX;
 		typedef typename T::GFpE  GFpE;
 		typedef typename T::GFpEX GFpEX;
 
+		ProbeScope probe(PROBE_CANTOR89);
+		probe.coefficients((2*p - 1) * (deg(Q) + 1) * GFpE::degree());
 		// X mod Phi(X), the (2p-1)th root of unity
 		GFpE omega; GFpX omegaX;
 		SetX(omegaX); conv(omega, omegaX);
@@ -49,12 +88,13 @@ namespace FAAST {
 		for (long i = 1; i <= 2*p-2 ; i++)
 			omegas[i] = omegas[i-1]*omega;
 
-		// Qstar = prod_i Q(omega^i Y)
-		GFpEX Qstar; conv(Qstar, Q);
-		GFpEX Qtmp;
-		// WARNING : oughta do better by a subproduct tree
-		// approach
+		// Qstar = prod_i Q(omega^i Y), computed by a balanced
+		// subproduct tree, so that the operands of the products
+		// grow geometrically
+		vector<GFpEX> factors; factors.resize(2*p-1);
+		conv(factors[0], Q);
 		for (long i = 1 ; i <= 2*p-2 ; i++) {
+			GFpEX& Qtmp = factors[i];
 			long c = 0;
 			SetCoeff(Qtmp, deg(Q));  // hack to speed up GF2
 			for (long j = 0 ; j <= deg(Q) ; j++) {
@@ -62,8 +102,10 @@ namespace FAAST {
 					coeff(Q, j) * omegas[c]);
 				c += i; c %= 2*p - 1;
 			}
-			Qstar *= Qtmp;
 		}
+		CantorProductTask<T> tree(&factors, 0, 2*p-1, F);
+		tree.run();
+		const GFpEX& Qstar = factors[0];
 		// qstar( X^(2p-1) ) = Qstar
 		GFpX qstar;
 		long c = 0;
@@ -81,10 +123,7 @@ namespace FAAST {
 		}
 
 		// result = qstar(X^p - X)
-		GFpX xpminusx;
-		SetCoeff(xpminusx, p, 1);
-		SetCoeff(xpminusx, 1, -1);
-		compose<T>(res, qstar, xpminusx, p);
+		artinSchreierCompose<T>(res, qstar, p);
 	}
 
 
@@ -99,6 +138,14 @@ namespace FAAST {
 		// if the extension already exists, return it
 		// WARNING : this behavior is not correct when
 		// this field is the prime field of some other field
+		if (stem->overfield) {
+			memoryBarrier();
+			return *(stem->overfield);
+		}
+
+		// Only one thread builds the extension, the others
+		// wait for it to be published
+		ScopedLock guard(stem->extending);
 		if (stem->overfield) return *(stem->overfield);
 
 		// Build the extension (Section 3)
@@ -106,9 +153,8 @@ namespace FAAST {
 		// test if the characteristic stays in one word
 		if (p != long(p)) throw CharacteristicTooLargeException();
 
-#ifdef FAAST_TIMINGS
-		TIME.BUILDSTEM = -GetTime();
-#endif
+		ProbeScope probe(PROBE_BUILDSTEM);
+		probe.coefficients(long(p)*d + 1);
 		switchContext();
 		GFpX Q; bool po, tpmo;
 		FieldElement<T>* alpha;
@@ -138,19 +184,13 @@ namespace FAAST {
 					po = true;
 					if (d % p == 0) throw
 						NotSupportedException("I don't know how to build a primitive tower over this base field.");
-					// X-1
-					GFpX xminus1; SetX(xminus1); SetCoeff(xminus1,0,-1);
 					// Q_0* = Q_0(X-1)
-					compose<T>(Q0, Q0, xminus1, p);
+					taylorShift<T>(Q0, Q0, -1, p);
 					// alpha = x0 + 1
 					*alpha += stem->one();
 				}
-				// X^p - X
-				GFpX xpminusx;
-				SetCoeff(xpminusx, p, 1);
-				SetCoeff(xpminusx, 1, -1);
-				// Q_1 = Q_0
-				compose<T>(Q, Q0, xpminusx, p);
+				// Q_1 = Q_0(X^p - X)
+				artinSchreierCompose<T>(Q, Q0, p);
 			}
 		}
 		// second floor in characteristic 2,
@@ -159,12 +199,8 @@ namespace FAAST {
 			// extend modulo X^p - X - x1
 			po = false; tpmo = false;
 			const GFpX& Q0 = GFpE::modulus().val();
-			// X^p - X
-			GFpX xpminusx;
-			SetCoeff(xpminusx, p, 1);
-			SetCoeff(xpminusx, 1, -1);
-			// Q_1 = Q_0
-			compose<T>(Q, Q0, xpminusx, p);
+			// Q_2 = Q_1(X^p - X)
+			artinSchreierCompose<T>(Q, Q0, p);
 			// alpha = x1
 			alpha = new FieldElement<T>(*(stem->primitive));
 		}
@@ -178,7 +214,7 @@ namespace FAAST {
 			primeField().getCyclotomic().P.restore();
 			// apply Cantor's algorithm to compute the
 			// minimal polynomial
-			cantor89<T>(Q, Q0, p);
+			cantor89<T>(Q, Q0, p, stem);
 			// alpha = x1^(2p-1)
 			alpha = new FieldElement<T>(*(stem->primitive));
 			*alpha ^= long(2)*p - 1;
@@ -200,11 +236,11 @@ namespace FAAST {
 		// who generated this extension ?
 		const Field<T>* vsub = (stem == this)? NULL : this;
 
-		stem->overfield = new Field<T>(stem, ctxt, pri, po, tpmo, p,
+		const Field<T>* over = new Field<T>(stem, ctxt, pri, po, tpmo, p,
 										long(p)*d, height+1, alpha, vsub);
-#ifdef FAAST_TIMINGS
-		TIME.BUILDSTEM += GetTime();
-#endif
+		// publish the new level only once it is complete
+		memoryBarrier();
+		stem->overfield = over;
 
 		return *(stem->overfield);
 	}
@@ -280,15 +316,69 @@ namespace FAAST {
 			return;
 		}
 
-		// the algorithm ApplyInverse from Section 6
-		v.clear(); v.resize(p);
-		FieldElement<T> s = e;
-		v[0] = s.trace(*this);
-		v[long(p)-1] = -v[0];
-		for (BigInt j = 1 ; j < p ; j++) {
-			s *= *(parent->gen);
-			v[long(p)-1-long(j)] -= s.trace(*this);
+		// the algorithm ApplyInverse from Section 6, all the traces
+		// at once. With e = sum e_k x^k and gen^j = sum G_jk x^k in
+		// the bivariate basis, the trace form of X^p - X - alpha gives
+		//   Tr(e x^k) = -e_(p-1-k)            for k < p-1
+		//   Tr(e x^(p-1)) = -e_0 - e_(p-1)
+		//   Tr(e gen^j) = sum G_jk Tr(e x^k)
+		// The G_jk are precomputed, e is pushed down once.
+		const long q = long(p);
+		const vector<FieldElement<T> >& G = parent->getGenPushDowns();
+		vector<FieldElement<T> > down;
+		FAAST::pushDown(e, down);
+		down.resize(q);
+
+		// u[k] = -Tr(e x^k) and c[j] = -Tr(e gen^j), accumulated
+		// without reductions
+		vector<FieldElement<T> > c; c.resize(q);
+		switchContext();
+		if (stem->d == 1) {
+			vector<GFp> u; u.resize(q);
+			for (long k = 0 ; k < q ; k++)
+				if (down[q-1-k].parent_field) u[k] = down[q-1-k].repBase();
+			if (down[q-1].parent_field) u[q-1] += down[q-1].repBase();
+			GFp acc, t;
+			for (long j = 0 ; j < q ; j++) {
+				clear(acc);
+				for (long k = 0 ; k < q ; k++) {
+					mul(t, G[j*q + k].repBase(), u[k]);
+					add(acc, acc, t);
+				}
+				c[j] = FieldElement<T>(this, acc);
+			}
+		} else {
+			vector<GFpX> u; u.resize(q);
+			for (long k = 0 ; k < q ; k++) {
+				const FieldElement<T>& x = down[q-1-k];
+				if (!x.parent_field) continue;
+				if (x.base) conv(u[k], x.repBase());
+				else u[k] = rep(x.repExt());
+			}
+			if (down[q-1].parent_field) {
+				const FieldElement<T>& x = down[q-1];
+				if (x.base) add(u[q-1], u[q-1], x.repBase());
+				else add(u[q-1], u[q-1], rep(x.repExt()));
+			}
+			GFpX acc, t;
+			GFpE r;
+			for (long j = 0 ; j < q ; j++) {
+				clear(acc);
+				for (long k = 0 ; k < q ; k++) {
+					mul(t, rep(G[j*q + k].repExt()), u[k]);
+					add(acc, acc, t);
+				}
+				conv(r, acc);
+				c[j] = FieldElement<T>(this, r);
+			}
 		}
+
+		// the coordinates
+		v.clear(); v.resize(q);
+		v[q-1] = c[0];
+		for (long j = 1 ; j < q - 1 ; j++)
+			v[q-1-j] = c[j];
+		v[0] = c[q-1] - c[0];
 	}
 
 	/* Lift the elements in v up to this field and store the result in e.
@@ -333,13 +423,51 @@ namespace FAAST {
 		if (parent->stem->overfield != stem)
 			throw IllegalCoercionException();
 
-		// the algorithm ApplyIsomorphism from Section 6
-		e = zero();
-		typename vector<FieldElement<T> >::const_reverse_iterator rit;
-		for (rit = v.rbegin() ; rit != v.rend() ; rit++) {
-			e *= *gen;
-			e += *rit >> *this;
+		// the algorithm ApplyIsomorphism from Section 6, as one
+		// change of basis. With gen^j = sum G_jk x^k in the bivariate
+		// basis,
+		//   sum v_j gen^j = sum_k (sum_j v_j G_jk) x^k
+		// The elements of v are already in the representation of the
+		// stem of the subfield, the G_jk are precomputed and the right
+		// hand side is lifted up once.
+		const long q = long(p);
+		const long n = min(q, long(v.size()));
+		const vector<FieldElement<T> >& G = getGenPushDowns();
+		const Field<T>* sub = parent->stem;
+		vector<FieldElement<T> > w; w.resize(q);
+		sub->switchContext();
+		if (sub->d == 1) {
+			GFp acc, t;
+			for (long k = 0 ; k < q ; k++) {
+				clear(acc);
+				for (long j = 0 ; j < n ; j++) {
+					if (!v[j].parent_field) continue;
+					mul(t, G[j*q + k].repBase(), v[j].repBase());
+					add(acc, acc, t);
+				}
+				w[k] = FieldElement<T>(sub, acc);
+			}
+		} else {
+			vector<GFpX> u; u.resize(n);
+			for (long j = 0 ; j < n ; j++) {
+				if (!v[j].parent_field) continue;
+				if (v[j].base) conv(u[j], v[j].repBase());
+				else u[j] = rep(v[j].repExt());
+			}
+			GFpX acc, t;
+			GFpE r;
+			for (long k = 0 ; k < q ; k++) {
+				clear(acc);
+				for (long j = 0 ; j < n ; j++) {
+					mul(t, rep(G[j*q + k].repExt()), u[j]);
+					add(acc, acc, t);
+				}
+				conv(r, acc);
+				w[k] = FieldElement<T>(sub, r);
+			}
 		}
+		FAAST::liftUp(w, e);
+		e.parent_field = this;
 	}
 
 }
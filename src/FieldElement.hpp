@@ -23,26 +23,27 @@ namespace FAAST {
 /****************** Copy ******************/
 	template <class T>
 	FieldElement<T>::FieldElement(const FieldElement<T>& e) throw() :
-	repBase(), repExt(), base(e.base), parent_field(e.parent_field) {
-		if (parent_field) {
-			parent_field->switchContext();
-			if (base) repBase = e.repBase;
-			else repExt = e.repExt;
-		}
+	base(e.base), parent_field(e.parent_field) {
+		// the special 0 : no modulus may be installed in this thread
+		if (!parent_field) { constructRep(); return; }
+		parent_field->switchContext();
+		if (base) new (storage.baseStorage) GFp(e.repBase());
+		else new (storage.extStorage) GFpE(e.repExt());
 	}
 
 	template <class T> FieldElement<T>&
 	FieldElement<T>::operator=(const FieldElement<T>& e) throw() {
-		base = e.base;
 		parent_field = e.parent_field;
-		if (parent_field) {
-			parent_field->switchContext();
-			if (base) { repBase = e.repBase; repExt = 0; }
-			else { repExt = e.repExt; repBase = 0; }
-		} else {
-			repBase = 0;
-			repExt = 0;
+		if (!parent_field) {
+			destroyRep();
+			base = e.base;
+			constructRep();
+			return *this;
 		}
+		parent_field->switchContext();
+		setBase(e.base);
+		if (base) repBase() = e.repBase();
+		else repExt() = e.repExt();
 		return *this;
 	}
 
@@ -54,10 +55,8 @@ namespace FAAST {
 			else throw UndefinedFieldException();
 		}
 		parent_field->switchContext();
-		repBase = 0;
-		repExt = 0;
-		if (base) repBase = i;
-		else repExt = i;
+		if (base) repBase() = i;
+		else repExt() = i;
 		return *this;
 	}
 
@@ -74,24 +73,24 @@ namespace FAAST {
 		if (base && !e.base &&
 			&(e.parent_field->primeField()) == parent_field) {
 			e.parent_field->switchContext();
-			repExt = e.repExt;
-			repExt += repBase;
-			repBase = 0;
-			base = false;
+			const GFp c = repBase();
+			setBase(false);
+			repExt() = e.repExt();
+			repExt() += c;
 			parent_field = e.parent_field;
 			return;
 		}
 		if (!base && e.base &&
 			&(parent_field->primeField()) == e.parent_field) {
 			parent_field->switchContext();
-			repExt += e.repBase;
+			repExt() += e.repBase();
 			return;
 		}
 
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase += e.repBase;
-		else repExt += e.repExt;
+		if (base) repBase() += e.repBase();
+		else repExt() += e.repExt();
 	}
 
 	template <class T> void
@@ -106,24 +105,24 @@ namespace FAAST {
 		if (base && !e.base &&
 			&(e.parent_field->primeField()) == parent_field) {
 			e.parent_field->switchContext();
-			repExt = e.repExt;
-			repExt -= repBase;
-			repBase = 0;
-			base = false;
+			const GFp c = repBase();
+			setBase(false);
+			repExt() = e.repExt();
+			repExt() -= c;
 			parent_field = e.parent_field;
 			return;
 		}
 		if (!base && e.base &&
 			&(parent_field->primeField()) == e.parent_field) {
 			parent_field->switchContext();
-			repExt -= e.repBase;
+			repExt() -= e.repBase();
 			return;
 		}
 
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase -= e.repBase;
-		else repExt -= e.repExt;
+		if (base) repBase() -= e.repBase();
+		else repExt() -= e.repExt();
 	}
 
 	template <class T> void
@@ -141,24 +140,24 @@ namespace FAAST {
 		if (base && !e.base &&
 			&(e.parent_field->primeField()) == parent_field) {
 			e.parent_field->switchContext();
-			repExt = e.repExt;
-			repExt *= repBase;
-			repBase = 0;
-			base = false;
+			const GFp c = repBase();
+			setBase(false);
+			repExt() = e.repExt();
+			repExt() *= c;
 			parent_field = e.parent_field;
 			return;
 		}
 		if (!base && e.base &&
 			&(parent_field->primeField()) == e.parent_field) {
 			parent_field->switchContext();
-			repExt *= e.repBase;
+			repExt() *= e.repBase();
 			return;
 		}
 
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase *= e.repBase;
-		else repExt *= e.repExt;
+		if (base) repBase() *= e.repBase();
+		else repExt() *= e.repExt();
 	}
 
 	template <class T> void
@@ -172,24 +171,24 @@ namespace FAAST {
 		if (base && !e.base &&
 			&(e.parent_field->primeField()) == parent_field) {
 			e.parent_field->switchContext();
-			repExt = e.repExt;
-			repExt /= repBase;
-			repBase = 0;
-			base = false;
+			const GFp c = repBase();
+			setBase(false);
+			repExt() = e.repExt();
+			repExt() /= c;
 			parent_field = e.parent_field;
 			return;
 		}
 		if (!base && e.base &&
 			&(parent_field->primeField()) == e.parent_field) {
 			parent_field->switchContext();
-			repExt /= e.repBase;
+			repExt() /= e.repBase();
 			return;
 		}
 
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase /= e.repBase;
-		else repExt /= e.repExt;
+		if (base) repBase() /= e.repBase();
+		else repExt() /= e.repExt();
 	}
 
 	/* Unary operations */
@@ -201,8 +200,7 @@ namespace FAAST {
 		if (base) return *this;
 		else {
 			FieldElement<T> tmp;
-			NTL::trace(tmp.repBase, repExt);
-			tmp.base = true;
+			NTL::trace(tmp.repBase(), repExt());
 			tmp.parent_field = &(parent_field->primeField());
 			return tmp;
 		}
@@ -212,32 +210,44 @@ namespace FAAST {
  	template <class T> void FieldElement<T>::negate() throw() {
  		if (!parent_field) return;
  		parent_field->switchContext();
- 		if (base) NTL::negate(repBase, repBase);
- 		else NTL::negate(repExt, repExt);
+ 		if (base) NTL::negate(repBase(), repBase());
+ 		else NTL::negate(repExt(), repExt());
  	}
 
-	template <class T> void FieldElement<T>::self_inv()
-	throw(DivisionByZeroException) {
+	template <class T> void FieldElement<T>::self_inv(
+	const InversionMethod method) throw(DivisionByZeroException) {
 		if (isZero()) throw DivisionByZeroException();
+		if (!base && (method == INV_ITOH_TSUJII || (method == INV_AUTO &&
+		T::consts.ItohTsujii_CROSSOVER > 0 &&
+		parent_field->d >= T::consts.ItohTsujii_CROSSOVER))) {
+			ItohTsujiiInv();
+			return;
+		}
 		parent_field->switchContext();
-		if (base) NTL::inv(repBase, repBase);
-		else NTL::inv(repExt, repExt);
+		if (base) NTL::inv(repBase(), repBase());
+		else NTL::inv(repExt(), repExt());
 	}
 
 	template <class T> void FieldElement<T>::operator^=(const ZZ& i)
 	throw() {
 		if (!parent_field) return;
+		// exponents of at most two digits in base p, such as the 2p-1
+		// of ArtinSchreierExtension(), gain nothing from the Frobenius
+		if (!base && !isZero() && sign(i) > 0 &&
+		    NumBits(i) > 2 * NumBits(parent_field->p) && FrobPower(i)) return;
 		parent_field->switchContext();
-		if (base) power(repBase, repBase, i);
-		else power(repExt, repExt, i);
+		if (base) power(repBase(), repBase(), i);
+		else power(repExt(), repExt(), i);
 	}
 
 	template <class T> void FieldElement<T>::operator^=(const long i)
 	throw() {
 		if (!parent_field) return;
+		if (!base && !isZero() && i > 0 &&
+		    NumBits(i) > 2 * NumBits(parent_field->p) && FrobPower(to_ZZ(i))) return;
 		parent_field->switchContext();
-		if (base) power(repBase, repBase, i);
-		else power(repExt, repExt, i);
+		if (base) power(repBase(), repBase(), i);
+		else power(repExt(), repExt(), i);
 	}
 
 	template <class T> void FieldElement<T>::self_frobenius()
@@ -247,7 +257,7 @@ namespace FAAST {
 
 		parent_field->switchContext();
 
-		power(repExt, repExt, parent_field->p);
+		power(repExt(), repExt(), parent_field->p);
 	}
 
 	template <class T> void FieldElement<T>::self_trace() throw() {
@@ -255,9 +265,10 @@ namespace FAAST {
 		parent_field->switchContext();
 		if (base) return;
 		else {
-			NTL::trace(repBase, repExt);
-			base = true;
-			repExt = 0;
+			GFp t;
+			NTL::trace(t, repExt());
+			setBase(true);
+			repBase() = t;
 			parent_field = &(parent_field->baseField());
 		}
 	}
@@ -276,8 +287,8 @@ namespace FAAST {
 #endif
 
 		parent_field->switchContext();
-		if (deg(rep(repExt)) <= 0) {
-			GFp e = coeff(rep(repExt), 0);
+		if (deg(rep(repExt())) <= 0) {
+			GFp e = coeff(rep(repExt()), 0);
 			return FieldElement<T>(
 					&(parent_field->primeField()), e);
 		} else throw IllegalCoercionException();
@@ -360,12 +371,12 @@ namespace FAAST {
 		if (!parent_field) return e.isZero();
 		if (!e.parent_field) return isZero();
 		sameLevel(e);
-		return base ? repBase == e.repBase : repExt == e.repExt;
+		return base ? repBase() == e.repBase() : repExt() == e.repExt();
 	}
 	template <class T> bool FieldElement<T>::operator==(const BigInt& i)
 	const throw() {
 		if (!parent_field) return i == long(0);
-		else return base ? repBase == i : repExt == i;
+		else return base ? repBase() == i : repExt() == i;
 	}
 	template <class T> bool FieldElement<T>::isScalar() const
 	throw() {
@@ -375,7 +386,7 @@ namespace FAAST {
 			FAASTException("Malformed element in isScalar().");
 #endif
 		parent_field->switchContext();
-		return deg(rep(repExt)) <= 0;
+		return deg(rep(repExt())) <= 0;
 	}
 
 /****************** Infrastructure ******************/
@@ -386,20 +397,20 @@ namespace FAAST {
 	const throw(IllegalCoercionException) {
 		if (!parent_field || !base) throw IllegalCoercionException();
 		parent_field->switchContext();
-		i = repBase;
+		i = repBase();
 	}
 	template <class T> void FieldElement<T>::toInfrastructure(GFpE& i)
 	const throw(IllegalCoercionException) {
 		if (!parent_field || base) throw IllegalCoercionException();
 		parent_field->switchContext();
-		i = repExt;
+		i = repExt();
 	}
 
 /****************** Printing ******************/
 	template <class T> ostream& FieldElement<T>::print(ostream& o) const {
 		if (!parent_field) return o << 0;
-		if (base) return o << repBase;
-		else return o << repExt;
+		if (base) return o << repBase();
+		else return o << repExt();
 	}
 
 	/* Print the element as a polynomial over GF(p) in the
@@ -408,12 +419,12 @@ namespace FAAST {
 	template <class T> ostream&
 	FieldElement<T>::print(ostream& o, const string& var) const {
 		if (isZero()) return o << 0;
-		if (base) return o << repBase;
+		if (base) return o << repBase();
 		else {
 			bool first = true;
 			GFp c;
-			for (long i = deg(rep(repExt)) ; i >= 0 ; i--) {
-				if ((c = coeff(rep(repExt), i)) != 0) {
+			for (long i = deg(rep(repExt())) ; i >= 0 ; i--) {
+				if ((c = coeff(rep(repExt()), i)) != 0) {
 					if (first) first = false;
 					else o << " + ";
 					if (c != 1) o << c;
@@ -439,7 +450,7 @@ namespace FAAST {
 	FieldElement<T>::print(ostream& o, const vector<string>& vars)
 	const {
 		if (isZero()) return o << 0;
-		if (base) return o << repBase;
+		if (base) return o << repBase();
 		if (long(vars.size()) < parent_field->height + 1)
 			throw BadParametersException("Not enough variables");
 		if (parent_field->height == 0) {
@@ -467,4 +478,36 @@ namespace FAAST {
 		}
 	}
 
+
+/****************** Batch inversion ******************/
+	/* Montgomery's trick : with c_j the product of the first j nonzero
+	 * elements, 1/c_n is computed by one inversion, then for j = n..2
+	 *	1/a_j = c_(j-1) / c_j,	1/c_(j-1) = a_j / c_j
+	 */
+	template <class T>
+	void invertBatch(FieldElement<T>* e, const long n, vector<long>& zeros)
+	throw(NotInSameFieldException) {
+		zeros.clear();
+		vector<long> idx;
+		for (long i = 0 ; i < n ; i++) {
+			if (e[i].isZero()) zeros.push_back(i);
+			else {
+				if (!idx.empty()) e[i].sameLevel(e[idx[0]]);
+				idx.push_back(i);
+			}
+		}
+		if (idx.empty()) return;
+
+		const long m = idx.size();
+		vector<FieldElement<T> > c; c.resize(m);
+		c[0] = e[idx[0]];
+		for (long j = 1 ; j < m ; j++) c[j] = c[j-1] * e[idx[j]];
+		FieldElement<T> inv = c[m-1].inv(), tmp;
+		for (long j = m-1 ; j > 0 ; j--) {
+			tmp = inv * c[j-1];
+			inv *= e[idx[j]];
+			e[idx[j]] = tmp;
+		}
+		e[idx[0]] = inv;
+	}
 }
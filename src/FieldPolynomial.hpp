@@ -25,20 +25,17 @@ namespace FAAST {
 	template <class T> long FieldPolynomial<T>::degree()
 	const throw() {
 		if (!parent_field) return -1;
-		if (base) return deg(repBase);
-		else return deg(repExt);
+		if (base) return deg(repBase());
+		else return deg(repExt());
 	}
 
 /****************** Copy ******************/
 	template <class T>
 	FieldPolynomial<T>::FieldPolynomial(const FieldPolynomial<T>& e)
-	throw() : repBase(), repExt(), base(e.base),
-	parent_field(e.parent_field) {
-		if (parent_field) {
-			parent_field->switchContext();
-			if (base) repBase = e.repBase;
-			else repExt = e.repExt;
-		}
+	throw() : base(e.base), parent_field(e.parent_field) {
+		if (parent_field) parent_field->switchContext();
+		if (base) new (storage.baseStorage) GFpX(e.repBase());
+		else new (storage.extStorage) GFpEX(e.repExt());
 	}
 
 	template <class T> FieldPolynomial<T>&
@@ -47,35 +44,35 @@ namespace FAAST {
 		if (!e.parent_field) {
 			parent_field = NULL;
 			// free the storage
-			repBase.kill();
-			repExt.kill();
+			if (base) repBase().kill();
+			else repExt().kill();
 			return *this;
 		}
 
 		// if the modulus has changed, we free the storage
 		if (parent_field && parent_field->stemField() != e.parent_field->stemField()) {
-			repBase.kill();
-			repExt.kill();
+			if (base) repBase().kill();
+			else repExt().kill();
 		}
 
-		base = e.base;
 		parent_field = e.parent_field;
 		parent_field->switchContext();
 
-		if (base) { repBase = e.repBase; repExt = 0; }
-		else { repExt = e.repExt; repBase = 0; }
+		setBase(e.base);
+		if (base) repBase() = e.repBase();
+		else repExt() = e.repExt();
 		return *this;
 	}
 
 	/* Starting only from the constant coefficient */
 	template <class T>
 	FieldPolynomial<T>::FieldPolynomial(const FieldElement<T>& e)
-	throw() : repBase(), repExt(), base(e.base),
-	parent_field(e.parent_field) {
+	throw() : base(e.base), parent_field(e.parent_field) {
+		constructRep();
 		if (parent_field) {
 			parent_field->switchContext();
-			if (base) SetCoeff(repBase, 0, e.repBase);
-			else SetCoeff(repExt, 0, e.repExt);
+			if (base) SetCoeff(repBase(), 0, e.repBase());
+			else SetCoeff(repExt(), 0, e.repExt());
 		}
 	}
 
@@ -85,25 +82,28 @@ namespace FAAST {
 		if (!e.parent_field) {
 			parent_field = NULL;
 			// free the storage
-			repBase.kill();
-			repExt.kill();
+			if (base) repBase().kill();
+			else repExt().kill();
 			return *this;
 		}
 
 		// if the modulus has changed, we free the storage
 		if (parent_field && parent_field->stemField() != e.parent_field->stemField()) {
-			repBase.kill();
-			repExt.kill();
+			if (base) repBase().kill();
+			else repExt().kill();
 		}
 
-		repBase = 0;
-		repExt = 0;
-		base = e.base;
 		parent_field = e.parent_field;
-
 		parent_field->switchContext();
-		if (base) SetCoeff(repBase, 0, e.repBase);
-		else SetCoeff(repExt, 0, e.repExt);
+
+		setBase(e.base);
+		if (base) {
+			repBase() = 0;
+			SetCoeff(repBase(), 0, e.repBase());
+		} else {
+			repExt() = 0;
+			SetCoeff(repExt(), 0, e.repExt());
+		}
 		return *this;
 	}
 
@@ -115,10 +115,13 @@ namespace FAAST {
 			else throw UndefinedFieldException();
 		}
 		parent_field->switchContext();
-		repBase = 0;
-		repExt = 0;
-		if (base) SetCoeff(repBase, 0, i);
-		else SetCoeff(repExt, i);
+		if (base) {
+			repBase() = 0;
+			SetCoeff(repBase(), 0, i);
+		} else {
+			repExt() = 0;
+			SetCoeff(repExt(), i);
+		}
 		return *this;
 	}
 
@@ -135,9 +138,9 @@ namespace FAAST {
 
 		parent_field->switchContext();
 		e.parent_field = parent_field;
-		e.base = base;
-		if (base) { e.repBase = coeff(repBase, i); e.repExt = 0; }
-		else { e.repExt = coeff(repExt, i); e.repBase = 0; }
+		e.setBase(base);
+		if (base) e.repBase() = coeff(repBase(), i);
+		else e.repExt() = coeff(repExt(), i);
 	}
 
 	template <class T> void
@@ -149,17 +152,17 @@ namespace FAAST {
 			if (!parent_field) return;
 
 			parent_field->switchContext();
-			if (base) SetCoeff(repBase, i, 0);
-			else SetCoeff(repExt, i, 0);
+			if (base) SetCoeff(repBase(), i, 0);
+			else SetCoeff(repExt(), i, 0);
 		} else {
 			if (!parent_field) {
 				parent_field = e.parent_field;
-				base = e.base;
+				setBase(e.base);
 			} else sameLevel(e);
 
 			parent_field->switchContext();
-			if (base) SetCoeff(repBase, i, e.repBase);
-			else SetCoeff(repExt, i, e.repExt);
+			if (base) SetCoeff(repBase(), i, e.repBase());
+			else SetCoeff(repExt(), i, e.repExt());
 		}
 	}
 
@@ -173,8 +176,8 @@ namespace FAAST {
 			throw UndefinedFieldException();
 
 		parent_field->switchContext();
-		if (base) SetCoeff(repBase, i, c);
-		else SetCoeff(repExt, i, c);
+		if (base) SetCoeff(repBase(), i, c);
+		else SetCoeff(repExt(), i, c);
 	}
 
 	template <class T> void
@@ -186,8 +189,8 @@ namespace FAAST {
 			throw UndefinedFieldException();
 
 		parent_field->switchContext();
-		if (base) SetCoeff(repBase, i);
-		else SetCoeff(repExt, i);
+		if (base) SetCoeff(repBase(), i);
+		else SetCoeff(repExt(), i);
 	}
 
 /****************** Arithmetics ******************/
@@ -202,8 +205,8 @@ namespace FAAST {
 		}
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase += e.repBase;
-		else repExt += e.repExt;
+		if (base) repBase() += e.repBase();
+		else repExt() += e.repExt();
 	}
 
 	template <class T> void
@@ -217,8 +220,8 @@ namespace FAAST {
 		}
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase -= e.repBase;
-		else repExt -= e.repExt;
+		if (base) repBase() -= e.repBase();
+		else repExt() -= e.repExt();
 	}
 
 	template <class T> void
@@ -235,8 +238,8 @@ namespace FAAST {
 		}
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase *= e.repBase;
-		else repExt *= e.repExt;
+		if (base) repBase() *= e.repBase();
+		else repExt() *= e.repExt();
 	}
 
 	template <class T> void
@@ -249,8 +252,8 @@ namespace FAAST {
 		}
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase /= e.repBase;
-		else repExt /= e.repExt;
+		if (base) repBase() /= e.repBase();
+		else repExt() /= e.repExt();
 	}
 
 	template <class T> void
@@ -263,8 +266,8 @@ namespace FAAST {
 		}
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) repBase %= e.repBase;
-		else repExt %= e.repExt;
+		if (base) repBase() %= e.repBase();
+		else repExt() %= e.repExt();
 	}
 
 	template <class T> void
@@ -273,12 +276,12 @@ namespace FAAST {
 			*this = a;
 			return;
 		}
-		base = a.base;
+		setBase(a.base);
 		parent_field = a.parent_field;
 
 		parent_field->switchContext();
-		if (base) NTL::LeftShift(repBase, a.repBase, n);
-		else NTL::LeftShift(repExt, a.repExt, n);
+		if (base) NTL::LeftShift(repBase(), a.repBase(), n);
+		else NTL::LeftShift(repExt(), a.repExt(), n);
 	}
 
 	template <class T> void
@@ -287,12 +290,12 @@ namespace FAAST {
 			*this = a;
 			return;
 		}
-		base = a.base;
+		setBase(a.base);
 		parent_field = a.parent_field;
 
 		parent_field->switchContext();
-		if (base) NTL::RightShift(repBase, a.repBase, n);
-		else NTL::RightShift(repExt, a.repExt, n);
+		if (base) NTL::RightShift(repBase(), a.repBase(), n);
+		else NTL::RightShift(repExt(), a.repExt(), n);
 	}
 
 	/* Unary operations */
@@ -303,40 +306,40 @@ namespace FAAST {
 		if (e.isZero()) return true;
 		sameLevel(e);
 		parent_field->switchContext();
-		if (base) return divide(e.repBase, repBase) == 1;
-		else return divide(e.repExt, repExt) == 1;
+		if (base) return divide(e.repBase(), repBase()) == 1;
+		else return divide(e.repExt(), repExt()) == 1;
 	}
 
 	/* Self-incrementing Unary operations */
 	template <class T> void FieldPolynomial<T>::negate() throw() {
  		if (!parent_field) return;
  		parent_field->switchContext();
- 		if (base) NTL::negate(repBase, repBase);
- 		else NTL::negate(repExt, repExt);
+ 		if (base) NTL::negate(repBase(), repBase());
+ 		else NTL::negate(repExt(), repExt());
 	}
 
 	template <class T> void
 	FieldPolynomial<T>::operator^=(const long i) throw() {
 		if (!parent_field) return;
 		parent_field->switchContext();
-		if (base) power(repBase, repBase, i);
-		else power(repExt, repExt, i);
+		if (base) power(repBase(), repBase(), i);
+		else power(repExt(), repExt(), i);
 	}
 
 	template <class T> void
 	FieldPolynomial<T>::self_derivative() throw() {
 		if (!parent_field) return;
 		parent_field->switchContext();
-		if (base) diff(repBase, repBase);
-		else diff(repExt, repExt);
+		if (base) diff(repBase(), repBase());
+		else diff(repExt(), repExt());
 	}
 
 	template <class T> void
 	FieldPolynomial<T>::normalize() throw() {
 		if (!parent_field) return;
 		parent_field->switchContext();
-		if (base) MakeMonic(repBase);
-		else MakeMonic(repExt);
+		if (base) MakeMonic(repBase());
+		else MakeMonic(repExt());
 	}
 
 	template <class T> void
@@ -346,9 +349,9 @@ namespace FAAST {
 
 		parent_field->switchContext();
 		GFpE tmp;
-		for (long i = deg(repExt) ; i >= 0 ; i--) {
-			power(tmp, coeff(repExt, i), parent_field->p);
-			SetCoeff(repExt, i, tmp);
+		for (long i = deg(repExt()) ; i >= 0 ; i--) {
+			power(tmp, coeff(repExt(), i), parent_field->p);
+			SetCoeff(repExt(), i, tmp);
 		}
 	}
 
@@ -384,10 +387,10 @@ namespace FAAST {
 		parent_field->switchContext();
 		GFpX e;
 		for (long i = degree() ; i >= 0 ; i--) {
-			if (deg(rep(coeff(repExt, i))) > 0)
+			if (deg(rep(coeff(repExt(), i))) > 0)
 				throw IllegalCoercionException();
 			else
-				SetCoeff(e, i, coeff(rep(coeff(repExt, i)), 0));
+				SetCoeff(e, i, coeff(rep(coeff(repExt(), i)), 0));
 		}
 
 		return FieldPolynomial<T>(&(parent_field->primeField()), e);
@@ -440,7 +443,7 @@ namespace FAAST {
 		if (!parent_field) return e.isZero();
 		if (!e.parent_field) return isZero();
 		sameLevel(e);
-		return base ? repBase == e.repBase : repExt == e.repExt;
+		return base ? repBase() == e.repBase() : repExt() == e.repExt();
 	}
 
 	template <class T> bool
@@ -452,10 +455,10 @@ namespace FAAST {
 		parent_field->switchContext();
 		// if e is a scalar
 		if (parent_field->primeField().isIsomorphic(e.parent()))
-			return base ? repBase == e.repBase : repExt == e.repBase;
+			return base ? repBase() == e.repBase() : repExt() == e.repBase();
 		// generic case
 		sameLevel(e);
-		return repExt == e.repExt;
+		return repExt() == e.repExt();
 	}
 
 	template <class T> bool
@@ -463,7 +466,7 @@ namespace FAAST {
 		if (!parent_field) return i == long(0);
 		else {
 			parent_field->switchContext();
-			return base ? repBase == i : repExt == i;
+			return base ? repBase() == i : repExt() == i;
 		}
 	}
 
@@ -478,7 +481,7 @@ namespace FAAST {
 
 		parent_field->switchContext();
 		for (long i = degree() ; i >= 0 ; i--) {
-			if (deg(rep(coeff(repExt, i))) > 0) return false;
+			if (deg(rep(coeff(repExt(), i))) > 0) return false;
 		}
 		return true;
 	}
@@ -492,7 +495,7 @@ namespace FAAST {
 	const throw(IllegalCoercionException) {
 		if (!parent_field || !base) throw IllegalCoercionException();
 		parent_field->switchContext();
-		p = repBase;
+		p = repBase();
 	}
 
 	template <class T> void
@@ -500,15 +503,15 @@ namespace FAAST {
 	const throw(IllegalCoercionException) {
 		if (!parent_field || base) throw IllegalCoercionException();
 		parent_field->switchContext();
-		p = repExt;
+		p = repExt();
 	}
 
 /****************** Printing ******************/
 	template <class T> ostream&
 	FieldPolynomial<T>::print(ostream& o) const {
 		if (!parent_field) return o << 0;
-		if (base) return o << repBase;
-		else return o << repExt;
+		if (base) return o << repBase();
+		else return o << repExt();
 	}
 
 	/* Print the element as a polynomial over the base field in the
@@ -568,4 +571,16 @@ namespace FAAST {
 		if (first) o << 0;
 		return o;
 	}
+
+/****************** Batch inversion ******************/
+	/* Invert the coefficients of P at once */
+	template <class T> void
+	invertBatch(FieldPolynomial<T>& P, vector<long>& zeros) throw() {
+		zeros.clear();
+		if (P.isZero()) return;
+		vector<FieldElement<T> > c; c.resize(P.degree() + 1);
+		for (long i = 0 ; i <= P.degree() ; i++) P.getCoeff(i, c[i]);
+		invertBatch(&c[0], c.size(), zeros);
+		for (long i = 0 ; i < long(c.size()) ; i++) P.setCoeff(i, c[i]);
+	}
 }
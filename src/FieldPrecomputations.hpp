@@ -22,6 +22,7 @@
 #include "FAAST/utilities.hpp"
 
 namespace FAAST {
+	/* The d-1 minor of the matrix of X^p - X, without the given line */
 	template <class T> typename T::MatGFp artinMatrix
 	(const typename T::BigInt& p, const long line, const typename T::GFpXModulus& P) {
 		typedef typename T::MatGFp      MatGFp;
@@ -46,65 +47,173 @@ namespace FAAST {
 			if (i > line) appl[i-1][i-1]--;
 			else if (i < line) appl[i][i-1]--;
 		}
-		//invert
-		return inv(appl);
+		return appl;
+	}
+
+	/* In place LU factorization with partial pivoting of the
+	 * invertible matrix A, so that P A = L U with L unit lower
+	 * triangular. Row k is exchanged with row piv[k] at step k.
+	 */
+	template <class T> void factorLU(typename T::MatGFp& A, vector<long>& piv) {
+		typedef typename T::GFp GFp;
+
+		const long n = A.NumRows();
+		piv.resize(n);
+		GFp l, t, u;
+		for (long k = 0 ; k < n ; k++) {
+			long r = k;
+			while (r < n && IsZero(A[r][k])) r++;
+#ifdef FAAST_DEBUG
+			if (r == n) throw FAASTException("Singular matrix in factorLU.");
+#endif
+			piv[k] = r;
+			if (r != k) swap(A[r], A[k]);
+			inv(l, A[k][k]);
+			for (long i = k + 1 ; i < n ; i++) {
+				if (IsZero(A[i][k])) continue;
+				mul(t, A[i][k], l);
+				A[i][k] = t;
+				for (long j = k + 1 ; j < n ; j++) {
+					mul(u, t, A[k][j]);
+					sub(u, A[i][j], u);
+					A[i][j] = u;
+				}
+			}
+		}
+	}
+
+	/* Solve A x = b, LU and piv being the output of factorLU on A */
+	template <class T> void solveLU(typename T::VecGFp& x,
+	const typename T::MatGFp& LU, const vector<long>& piv,
+	const typename T::VecGFp& b) {
+		typedef typename T::GFp GFp;
+
+		const long n = LU.NumRows();
+		x = b;
+		GFp acc, t;
+		for (long k = 0 ; k < n ; k++) {
+			if (piv[k] == k) continue;
+			t = x[k]; x[k] = x[piv[k]]; x[piv[k]] = t;
+		}
+		// L y = P b
+		for (long i = 1 ; i < n ; i++) {
+			acc = x[i];
+			for (long j = 0 ; j < i ; j++) {
+				mul(t, LU[i][j], x[j]);
+				sub(acc, acc, t);
+			}
+			x[i] = acc;
+		}
+		// U x = y
+		for (long i = n - 1 ; i >= 0 ; i--) {
+			acc = x[i];
+			for (long j = i + 1 ; j < n ; j++) {
+				mul(t, LU[i][j], x[j]);
+				sub(acc, acc, t);
+			}
+			div(acc, acc, LU[i][i]);
+			x[i] = acc;
+		}
 	}
 
 /****************** Access to precomputed values ******************/
+	/* All the getters below follow the same pattern : the fast path
+	 * reads the published flag, then the value, without locking;
+	 * the slow path computes the value under the lock of the stem
+	 * and publishes it last.
+	 */
+	/* Row j of the pseudotraces holds T(j,i), the (2^i p^j d)-th
+	 * pseudotraces of alpha, for 2^i <= p. With phi the (p^j d)-th
+	 * Frobenius,
+	 *   T(j,i+1) = T(j,i) + phi^(2^i)(T(j,i))
+	 * and T(j+1,0), the sum of the first p conjugates of T(j,0), is
+	 * obtained from the bits of p and row j in the same way. So a row
+	 * costs O(log p) BigFrob instead of p.
+	 */
 	template <class T> const FieldElement<T>&
-	Field<T>::getPseudotrace(const long j) const {
+	Field<T>::getPseudotrace(const long j, const long i) const {
 #ifdef FAAST_DEBUG
-		if (j < 0 || j >= height)
+		if (j < 0 || j >= height || i < 0 || i >= NumBits(p))
 			throw FAASTException("Bad input to getPseudotrace.");
 #endif
 
-		long size = pseudotraces.size();
-		if (size > j) return pseudotraces[j];
-		if (this != stem) return stem->getPseudotrace(j);
+		if (this != stem) return stem->getPseudotrace(j, i);
 
-#ifdef FAAST_TIMINGS
-		TIME.PSEUDOTRACES = -GetTime();
-#endif
-		pseudotraces.resize(j+1);
-		if (size == 0) {
-			pseudotraces[0] = *alpha;
-			pseudotraces[0].SmallPTrace(baseField().d);
-			size++;
-		}
-		for (long i = size ; i <= j ; i++) {
-			pseudotraces[i] = pseudotraces[i-1];
-			FieldElement<T> t = pseudotraces[i];
-			for (BigInt h = 1 ; h < p ; h++) {
-				t.BigFrob(i-1);
-				pseudotraces[i] += t;
-			}
-		}
-#ifdef FAAST_TIMINGS
-		TIME.PSEUDOTRACES += GetTime();
-#endif
+		const long width = NumBits(p);
+		if (pseudotracecount > j) {
+			memoryBarrier();
+			return pseudotraces[j*width + i];
+		}
+
+		ScopedLock guard(lock);
+		long size = pseudotracecount;
+		if (size > j) return pseudotraces[j*width + i];
 
-		return pseudotraces[j];
+		ProbeScope probe(PROBE_PSEUDOTRACES);
+		probe.coefficients((j + 1 - size) * width * d);
+		// never reallocate, the published pseudotraces may be
+		// read by other threads. The capacity is reserved by
+		// the constructor.
+		if (long(pseudotraces.size()) < height*width)
+			pseudotraces.resize(height*width);
+		for (long r = size ; r <= j ; r++) {
+			FieldElement<T>* row = &pseudotraces[r*width];
+			if (r == 0) {
+				row[0] = *alpha;
+				row[0].SmallPTrace(baseField().d);
+			} else {
+				const FieldElement<T>* prev = row - width;
+				bool first = true;
+				for (long k = 0 ; k < width ; k++) {
+					if ( !((long(p) >> k) & 1) ) continue;
+					if (first) {
+						row[0] = prev[k];
+						first = false;
+					} else {
+						row[0].BigFrob(r-1, k);
+						row[0] += prev[k];
+					}
+				}
+			}
+			for (long k = 1 ; k < width ; k++) {
+				row[k] = row[k-1];
+				// the (p^r d)-th Frobenius fixes the field
+				// of alpha when r = height - 1
+				if (r < height - 1) {
+					FieldElement<T> t = row[k-1];
+					t.BigFrob(r, k-1);
+					row[k] += t;
+				} else row[k] += row[k-1];
+			}
+			memoryBarrier();
+			pseudotracecount = r + 1;
+		}
+		return pseudotraces[j*width + i];
 	}
 
 	template <class T> const FieldElement<T>& Field<T>::getLiftup() const {
 		if (this != stem) return stem->getLiftup();
 
-		if ( !(liftuphelper.get()) ) {
+		if (ready & LIFTUP) {
+			memoryBarrier();
+			return *liftuphelper;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & LIFTUP) ) {
 			switchContext();
-#ifdef FAAST_TIMINGS
-			TIME.LIFTUP = -GetTime();
-#endif
+			ProbeScope probe(PROBE_LIFTUP);
+			probe.coefficients(d);
 			GFpX diffQ; diff(diffQ, GFpE::modulus());
 			FieldElement<T>* helper = new FieldElement<T>();
-			helper->base = false;
-			conv(helper->repExt, diffQ);
+			helper->setBase(false);
+			conv(helper->repExt(), diffQ);
 			helper->parent_field = this;
 
 			helper->self_inv();
 			liftuphelper.reset(helper);
-#ifdef FAAST_TIMINGS
-			TIME.LIFTUP += GetTime();
-#endif
+			memoryBarrier();
+			ready |= LIFTUP;
 		}
 		return *liftuphelper;
 	}
@@ -113,44 +222,388 @@ namespace FAAST {
 	T::MatGFp& Field<T>::getArtinMatrix() const {
 		if (this != stem) return stem->getArtinMatrix();
 
-		if (artinLine == -1 && d > 1) {
-			// We pick a redundant line : it corresponds
-			// to a power of x of trace different from 0.
-			// The residue formula tells us that Tr(x^dep) != 0
-			switchContext();
-			GFpXModulus P = GFpE::modulus();
-#ifdef FAAST_TIMINGS
-			TIME.ARTINMATRIX = -GetTime();
-#endif
-			artinLine = d - 1 - deg(diff(P));
-			artin = artinMatrix<T>(p,artinLine,P);
-#ifdef FAAST_TIMINGS
-			TIME.ARTINMATRIX += GetTime();
-#endif
+		if (ready & ARTIN) {
+			memoryBarrier();
+			return artin;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & ARTIN) ) {
+			if (d > 1) {
+				// We pick a redundant line : it corresponds
+				// to a power of x of trace different from 0.
+				// The residue formula tells us that Tr(x^dep) != 0
+				switchContext();
+				GFpXModulus P = GFpE::modulus();
+				ProbeScope probe(PROBE_ARTINMATRIX);
+				probe.coefficients((d - 1) * (d - 1));
+				const long line = d - 1 - deg(diff(P));
+				artin = artinMatrix<T>(p, line, P);
+				if (artinSolver == ARTIN_LU)
+					factorLU<T>(artin, artinPivots);
+				else
+					artin = inv(artin);
+				artinLine = line;
+			}
+			memoryBarrier();
+			ready |= ARTIN;
 		}
 		return artin;
 	}
 
+	template <class T> void
+	Field<T>::solveArtin(VecGFp& x, const VecGFp& b) const {
+		if (this != stem) return stem->solveArtin(x, b);
+
+		const MatGFp& A = getArtinMatrix();
+		if (artinSolver == ARTIN_LU)
+			solveLU<T>(x, A, artinPivots, b);
+		else
+			mul(x, A, b);
+	}
+
+/****************** Artin matrix management ******************/
+	template <class T> void
+	Field<T>::setArtinSolver(const ArtinSolver s) const {
+		const Field<T>& K = baseField();
+		ScopedLock guard(K.lock);
+		if (K.artinSolver == s) return;
+		K.artinSolver = s;
+		// compute it again if it was already there
+		if (K.ready & ARTIN) {
+			K.ready &= ~ARTIN;
+			K.getArtinMatrix();
+		}
+	}
+
+	/* The format is
+	 *   solver line n
+	 *   defining polynomial of the base field
+	 *   pivots (LU only)
+	 *   matrix
+	 */
+	template <class T> void Field<T>::saveArtinMatrix(ostream& o) const
+	throw(BadParametersException) {
+		const Field<T>& K = baseField();
+		if (K.d == 1)
+			throw BadParametersException("Prime fields have no Artin matrix.");
+		K.getArtinMatrix();
+		K.switchContext();
+		o << long(K.artinSolver) << " " << K.artinLine << " " << K.d - 1 << endl;
+		o << GFpE::modulus().val() << endl;
+		if (K.artinSolver == ARTIN_LU) {
+			for (unsigned long i = 0 ; i < K.artinPivots.size() ; i++)
+				o << K.artinPivots[i] << " ";
+			o << endl;
+		}
+		o << K.artin << endl;
+	}
+
+	template <class T> void Field<T>::loadArtinMatrix(istream& in) const
+	throw(BadParametersException) {
+		const Field<T>& K = baseField();
+		if (K.d == 1)
+			throw BadParametersException("Prime fields have no Artin matrix.");
+
+		ScopedLock guard(K.lock);
+		// Couveignes2000() reads the matrix without the lock
+		if (K.ready & ARTIN)
+			throw BadParametersException("The Artin matrix is already there.");
+		K.switchContext();
+		long solver, line, n;
+		in >> solver >> line >> n;
+		if (!in || (solver != ARTIN_INVERSE && solver != ARTIN_LU)
+		    || line < 0 || line >= K.d || n != K.d - 1)
+			throw BadParametersException("Bad Artin matrix header.");
+		GFpX P;
+		in >> P;
+		if (!in || P != GFpE::modulus().val())
+			throw BadParametersException("The Artin matrix is for another field.");
+		vector<long> piv;
+		if (solver == ARTIN_LU) {
+			piv.resize(n);
+			for (long i = 0 ; i < n ; i++) {
+				in >> piv[i];
+				if (!in || piv[i] < i || piv[i] >= n)
+					throw BadParametersException("Bad Artin matrix pivots.");
+			}
+		}
+		MatGFp mat;
+		in >> mat;
+		if (!in || mat.NumRows() != n || mat.NumCols() != n)
+			throw BadParametersException("Bad Artin matrix.");
+
+		K.artin = mat;
+		K.artinPivots = piv;
+		K.artinLine = line;
+		K.artinSolver = ArtinSolver(solver);
+		memoryBarrier();
+		K.ready |= ARTIN;
+	}
+
 	template <class T> const typename
 	T::Context& Field<T>::getCyclotomic() const {
 		if (this != stem) return stem->getCyclotomic();
 
-		switchContext();
-		if ( !(Phi.get()) ) {
+		if (ready & CYCLOTOMIC) {
+			memoryBarrier();
+			return *Phi;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & CYCLOTOMIC) ) {
+			switchContext();
 			GFpX phi;
-#ifdef FAAST_TIMINGS
-			TIME.CYCLOTOMIC = -GetTime();
-#endif
-			cyclotomic<T>(phi, 2*long(p)-1, p);
-#ifdef FAAST_TIMINGS
-			TIME.CYCLOTOMIC += GetTime();
-#endif
+			{
+				ProbeScope probe(PROBE_CYCLOTOMIC);
+				cyclotomic<T>(phi, 2*long(p)-1, p);
+				probe.coefficients(deg(phi) + 1);
+			}
 			GFpE::init(phi);
 			Context* ctxt = new Context();
 			ctxt->P.save();
 			Phi.reset(ctxt);
+			// GFpE::init changed the modulus behind our back
+			switchContext();
+			memoryBarrier();
+			ready |= CYCLOTOMIC;
 		}
 		return *Phi;
 	}
 
+	/* The modulus used to lift up from this field and its
+	 * trace form. If the overfield was built modulo
+	 *   X^p - X - x0 - 1
+	 * the modulus is shifted, so that it lies in GF(p)[x0+1].
+	 */
+	template <class T> const typename
+	T::GFpXModulus& Field<T>::getLiftupModulus() const {
+		if (this != stem) return stem->getLiftupModulus();
+
+		if (ready & TRACEFORM) {
+			memoryBarrier();
+			return *liftupmodulus;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & TRACEFORM) ) {
+			switchContext();
+			GFpXModulus* Q = new GFpXModulus(GFpE::modulus());
+			if (overfield && overfield->plusone) {
+				GFpX tmp;
+				taylorShift<T>(tmp, Q->val(), -1, p);
+				build(*Q, tmp);
+			}
+			if (Q->tracevec.length() == 0) {
+				ProbeScope probe(PROBE_TRACEVEC);
+				probe.coefficients(d);
+				ComputeTraceVec(*Q);
+			}
+			conv(traceform, Q->tracevec);
+			liftupmodulus.reset(Q);
+			memoryBarrier();
+			ready |= TRACEFORM;
+		}
+		return *liftupmodulus;
+	}
+
+	template <class T> const typename
+	T::GFpX& Field<T>::getTraceForm() const {
+		if (this != stem) return stem->getTraceForm();
+
+		getLiftupModulus();
+		return traceform;
+	}
+
+	/* The i-th table is for composing with X^(p^(2^i)) mod P, for
+	 * 2^i <= d. Each one is obtained by composing the previous one
+	 * with itself.
+	 */
+	template <class T> const vector<typename T::GFpXArgument>&
+	Field<T>::getFrobeniusTable() const {
+		if (this != stem) return stem->getFrobeniusTable();
+
+		if (ready & FROBENIUS) {
+			memoryBarrier();
+			return frobeniustable;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & FROBENIUS) ) {
+			switchContext();
+			const GFpXModulus& P = GFpE::modulus();
+			const long k = NumBits(d), m = SqrRoot(d);
+			ProbeScope probe(PROBE_FROBENIUS);
+			probe.coefficients(k * (m + 1) * d);
+			frobeniustable.resize(k);
+			GFpX h = PowerXMod(p, P);
+			for (long i = 0 ; i < k ; i++) {
+				build(frobeniustable[i], h, P, m);
+				if (i < k - 1) CompMod(h, h, frobeniustable[i], P);
+			}
+			memoryBarrier();
+			ready |= FROBENIUS;
+		}
+		return frobeniustable;
+	}
+
+	/* The tables used by approximateAS. The Bernoulli numbers are
+	 * obtained by inverting (e^z - 1)/z, all the factorials involved
+	 * are invertible modulo p.
+	 */
+	template <class T> const typename
+	T::VecGFp& Field<T>::getFactorials() const {
+		if (this != stem) return stem->getFactorials();
+
+		if (ready & BINOMIALS) {
+			memoryBarrier();
+			return factorials;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & BINOMIALS) ) {
+			switchContext();
+			const long q = long(p);
+			ProbeScope probe(PROBE_BINOMIALS);
+			probe.coefficients(3 * q);
+			factorials.SetLength(q);
+			invfactorials.SetLength(q);
+			GFp f; f = 1;
+			for (long i = 0 ; i < q ; i++) {
+				if (i > 0) f *= i;
+				factorials[i] = f;
+			}
+			f = inv(f);
+			for (long i = q - 1 ; i >= 0 ; i--) {
+				invfactorials[i] = f;
+				f *= i;
+			}
+			GFpX E;
+			for (long n = q - 2 ; n >= 0 ; n--)
+				SetCoeff(E, n, invfactorials[n+1]);
+			InvTrunc(bernoulli, E, q - 1);
+			memoryBarrier();
+			ready |= BINOMIALS;
+		}
+		return factorials;
+	}
+
+	template <class T> const typename
+	T::VecGFp& Field<T>::getInvFactorials() const {
+		if (this != stem) return stem->getInvFactorials();
+
+		getFactorials();
+		return invfactorials;
+	}
+
+	template <class T> const typename
+	T::GFpX& Field<T>::getBernoulli() const {
+		if (this != stem) return stem->getBernoulli();
+
+		getFactorials();
+		return bernoulli;
+	}
+
+	/* In a field that is not on the stem, the push-downs of 1, gen,
+	 * ..., gen^(p-1), the coefficients of gen^j being at positions
+	 * j*p, ..., j*p + p - 1. They are pushed down all at once. This
+	 * lives in the field itself, not in its stem.
+	 */
+	template <class T> const vector<FieldElement<T> >&
+	Field<T>::getGenPushDowns() const {
+		if (ready & ISOMORPHISM) {
+			memoryBarrier();
+			return genpushdowns;
+		}
+
+		ScopedLock guard(lock);
+		if ( !(ready & ISOMORPHISM) ) {
+			switchContext();
+			const long q = long(p);
+			ProbeScope probe(PROBE_ISOMORPHISM);
+			probe.coefficients(2 * q * d);
+			vector<FieldElement<T> > powers; powers.resize(q);
+			powers[0] = one();
+			for (long j = 1 ; j < q ; j++)
+				powers[j] = powers[j-1] * (*gen);
+			genpushdowns.resize(q * q);
+			pushDownBatch<T>(*this, &powers[0], q, &genpushdowns[0]);
+			memoryBarrier();
+			ready |= ISOMORPHISM;
+		}
+		return genpushdowns;
+	}
+
+	/* n powerings to the p cost about 3/2 n log(p) multiplications,
+	 * a Brent-Kung composition about 2 sqrt(d) and we need at most
+	 * 2 log(n) of them. Only base fields have a table.
+	 */
+	template <class T> bool Field<T>::useFrobeniusTable(const long n) const {
+		if (stem->height != 0 || d == 1) return false;
+		return 3 * n * NumBits(p) > 8 * NumBits(n) * SqrRoot(d);
+	}
+
+/****************** Warming up ******************/
+	/* One of the precomputations of a field */
+	template <class T> class Field<T>::PrecomputeTask : public Task {
+	public:
+		const Field<T>* F;
+		unsigned int what;
+
+		PrecomputeTask(const Field<T>* K, const unsigned int w)
+		: F(K), what(w) {}
+
+		void run() {
+			switch (what) {
+			case PSEUDOTRACES: F->getPseudotrace(F->height - 1); break;
+			case LIFTUP:       F->getLiftup();                   break;
+			case ARTIN:        F->getArtinMatrix();              break;
+			case CYCLOTOMIC:   F->getCyclotomic();               break;
+			case FROBENIUS:    F->getFrobeniusTable();           break;
+			case BINOMIALS:    F->getFactorials();               break;
+			case ISOMORPHISM:  F->getGenPushDowns();             break;
+			case TRACEFORM:    F->getLiftupModulus();            break;
+			}
+		}
+	};
+
+	template <class T> void
+	Field<T>::precompute(const unsigned int mask) const {
+		// The stems of the tower, from the prime field up
+		vector<const Field<T>*> tower;
+		for (const Field<T>* F = stem ; F ; F = F->subfield)
+			tower.push_back(F->stem);
+
+		vector<PrecomputeTask> tasks;
+		for (long i = tower.size() - 1 ; i >= 0 ; i--) {
+			const Field<T>* F = tower[i];
+			if (F->height >= 1) {
+				if (mask & PSEUDOTRACES)
+					tasks.push_back(PrecomputeTask(F, PSEUDOTRACES));
+				if (mask & LIFTUP)
+					tasks.push_back(PrecomputeTask(F, LIFTUP));
+			}
+			if ((mask & LIFTUP) && F->d > 1 && F->overfield)
+				tasks.push_back(PrecomputeTask(F, TRACEFORM));
+			if ((mask & ARTIN) && F->height == 0 && F->d > 1)
+				tasks.push_back(PrecomputeTask(F, ARTIN));
+			if ((mask & FROBENIUS) && F->height == 0 && F->d > 1)
+				tasks.push_back(PrecomputeTask(F, FROBENIUS));
+			if ((mask & CYCLOTOMIC) && F->isPrimeField())
+				tasks.push_back(PrecomputeTask(F, CYCLOTOMIC));
+			if ((mask & BINOMIALS) && F->isPrimeField() && height >= 1)
+				tasks.push_back(PrecomputeTask(F, BINOMIALS));
+		}
+		// fields out of the stem only have their change of basis
+		if ((mask & ISOMORPHISM) && this != stem)
+			tasks.push_back(PrecomputeTask(this, ISOMORPHISM));
+
+		// the tasks are never moved once spawned
+		TaskGroup group;
+		for (unsigned long i = 0 ; i < tasks.size() ; i++)
+			group.spawn(tasks[i]);
+		group.wait();
+		switchContext();
+	}
+
 }
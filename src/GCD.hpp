@@ -19,6 +19,7 @@
 	along with this program; see file COPYING. If not, write to the Free Software
 	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
+#include <fstream>
 
 namespace FAAST {
 /****************** GCD auxiliary routines ******************/
@@ -53,7 +54,37 @@ IterHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 
 
 
-/* Half GCD between P and Q, assumes deg P > deg Q */
+/* res = a * b, a task of RecHalfGCD */
+template <class T> class ProductTask : public Task {
+public:
+	FieldPolynomial<T> res;
+	const FieldPolynomial<T>* a;
+	const FieldPolynomial<T>* b;
+
+	void set(const FieldPolynomial<T>& x, const FieldPolynomial<T>& y)
+	{ a = &x; b = &y; }
+	void run() { res.product(*a, *b); }
+};
+
+/* Run the n products of tasks, in parallel if their size
+ * (degree times extension degree) is above the grain size
+ */
+template <class T> void
+products(ProductTask<T>* tasks, const long n, const long size) {
+	if (getThreads() > 1 && size >= getGrainSize()) {
+		TaskGroup group;
+		for (long i = 1 ; i < n ; i++) group.spawn(tasks[i]);
+		tasks[0].run();
+		group.wait();
+	} else {
+		for (long i = 0 ; i < n ; i++) tasks[i].run();
+	}
+}
+
+/* Half GCD between P and Q, assumes deg P > deg Q.
+ * The independent products of the two matrix products
+ * run in parallel.
+ */
 template <class T> void
 RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 		FieldPolynomial<T>& U1, FieldPolynomial<T>& V1,
@@ -74,7 +105,7 @@ RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 	P1.RightShift(P, n);
 	Q1.RightShift(Q, n);
 
-	if (d <= T::consts.HalfGCD_CROSSOVER) {
+	if (d <= T::consts.halfGCDCrossover(P.parent().degree())) {
 		IterHalfGCD<T>(U0, V0, U1, V1, P1, Q1, d);
 		return;
 	}
@@ -87,13 +118,13 @@ RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 	// matrix-vector product
 	// |P1|    |u0 v0| |P1|
 	// |Q1| <- |u1 v1| |Q1|
-	FieldPolynomial<T> t1, t2;
-	t1.product(u0, P1);
-	t2.product(v0, Q1);
-	t1 += t2;
-	t2.product(u1, P1);
-	Q1 *= v1; Q1 += t2;
-	P1 = t1;
+	FieldPolynomial<T> t1;
+	ProductTask<T> m[7];
+	m[0].set(u0, P1); m[1].set(v0, Q1);
+	m[2].set(u1, P1); m[3].set(v1, Q1);
+	products<T>(m, 4, d * P.parent().degree());
+	P1.sum(m[0].res, m[1].res);
+	Q1.sum(m[2].res, m[3].res);
 
 	long d2 = Q1.degree() - P.degree() + n + d;
 
@@ -121,26 +152,25 @@ RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 	// |U1 V1| = |y1 w1| |u1 v1|
 	U0 = V0 = U1 = V1 = P.parent().zero();
 
-	t1.difference(y0, w0); t1 *= v1;
-	U0 += t1; V0 -= t1;
-
-	t1.difference(y1, w1); t1 *= u0;
-	U1 += t1; V1 -= t1;
-
-	t1.sum(u0, u1); t1 *= w1;
-	U0 -= t1; U1 += t1;
-
-	t1.sum(v0, v1); t1 *= y0;
-	V0 += t1; V1 -= t1;
-
-	t2.sum(y0, w1); t1.difference(v1, u0); t1 *= t2;
-	U0 -= t1; V1 += t1;
-
-	t2.sum(y0, y1); t1.sum(u0, v0); t1 *= t2;
-	V1 += t1;
-
-	t2.sum(w0, w1); t1.sum(u1, v1); t1 *= t2;
-	U0 += t1;
+	FieldPolynomial<T> s[10];
+	s[0].difference(y0, w0); s[1].difference(y1, w1);
+	s[2].sum(u0, u1);        s[3].sum(v0, v1);
+	s[4].sum(y0, w1);        s[5].difference(v1, u0);
+	s[6].sum(y0, y1);        s[7].sum(u0, v0);
+	s[8].sum(w0, w1);        s[9].sum(u1, v1);
+	m[0].set(s[0], v1); m[1].set(s[1], u0);
+	m[2].set(s[2], w1); m[3].set(s[3], y0);
+	m[4].set(s[4], s[5]); m[5].set(s[6], s[7]);
+	m[6].set(s[8], s[9]);
+	products<T>(m, 7, d * P.parent().degree());
+
+	U0 += m[0].res; V0 -= m[0].res;
+	U1 += m[1].res; V1 -= m[1].res;
+	U0 -= m[2].res; U1 += m[2].res;
+	V0 += m[3].res; V1 -= m[3].res;
+	U0 -= m[4].res; V1 += m[4].res;
+	V1 += m[5].res;
+	U0 += m[6].res;
 }
 
 
@@ -156,7 +186,7 @@ RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 		P.parent_field->switchContext();
 
 		FieldPolynomial<T> res = P.parent_field->zero();
-		if (P.base) NTL::GCD(res.repBase, P.repBase, Q.repBase);
+		if (P.base) NTL::GCD(res.repBase(), P.repBase(), Q.repBase());
 		else {
 			FieldPolynomial<T> U, V;
 			XGCD<T>(P, Q, U, V, res);
@@ -224,4 +254,97 @@ RecHalfGCD(FieldPolynomial<T>& U0, FieldPolynomial<T>& V0,
 			}
 		}
 	}
+
+/****************** Tuning ******************/
+	/* Average time of RecHalfGCD on P and Q with crossover c, the
+	 * calls are repeated until they take some hundredths of second.
+	 */
+	template <class T> double
+	timeHalfGCD(const FieldPolynomial<T>& P, const FieldPolynomial<T>& Q,
+	const long c) {
+		const long b = Constants::bucket(P.parent().degree());
+		T::consts.HalfGCD_TUNED[b] = c;
+		FieldPolynomial<T> U0, V0, U1, V1;
+		long reps = 0;
+		double cputime = -NTL::GetTime();
+		do {
+			RecHalfGCD<T>(U0, V0, U1, V1, P, Q, P.degree()+1);
+			reps++;
+		} while (cputime + NTL::GetTime() < 0.02);
+		cputime += NTL::GetTime();
+		return cputime / reps;
+	}
+
+	/* Tune the crossover of the bucket of K, unless it is already
+	 * known or found in file. The candidates are powers of 2, the
+	 * timings are done on random polynomials of degree twice the
+	 * largest candidate.
+	 */
+	template <class T> long
+	tuneHalfGCD(const Field<T>& K, const char* file)
+	throw(BadParametersException) {
+		const long b = Constants::bucket(K.degree());
+		if (file && T::consts.HalfGCD_TUNED[b] <= 0) {
+			ifstream in(file);
+			if (in) loadHalfGCDCrossovers<T>(in);
+		}
+		if (T::consts.HalfGCD_TUNED[b] > 0)
+			return T::consts.HalfGCD_TUNED[b];
+
+		const long n = 256;
+		FieldPolynomial<T> P, Q;
+		for (long i = 0 ; i < n ; i++) {
+			P.setCoeff(i, K.random());
+			Q.setCoeff(i, K.random());
+		}
+		P.setCoeff(n);
+
+		long best = 0;
+		double besttime = 0;
+		for (long c = 4 ; c <= n/2 ; c *= 2) {
+			const double t = timeHalfGCD<T>(P, Q, c);
+			if (best == 0 || t < besttime) {
+				best = c; besttime = t;
+			}
+		}
+		T::consts.HalfGCD_TUNED[b] = best;
+
+		if (file) {
+			ofstream out(file);
+			if (!out)
+				throw BadParametersException("Cannot write the HalfGCD crossovers.");
+			saveHalfGCDCrossovers<T>(out);
+		}
+		return best;
+	}
+
+	/* The format is
+	 *   infrastructure name
+	 *   bucket crossover
+	 *   ...
+	 * with one line per tuned bucket.
+	 */
+	template <class T> void saveHalfGCDCrossovers(ostream& o) {
+		o << T::name << endl;
+		for (long i = 0 ; i < Constants::BUCKETS ; i++) {
+			if (T::consts.HalfGCD_TUNED[i] > 0)
+				o << i << " " << T::consts.HalfGCD_TUNED[i] << endl;
+		}
+	}
+
+	template <class T> void loadHalfGCDCrossovers(istream& in)
+	throw(BadParametersException) {
+		string name;
+		in >> name;
+		if (!in || name != T::name)
+			throw BadParametersException("HalfGCD crossovers of another infrastructure.");
+		long b, c;
+		while (in >> b >> c) {
+			if (b < 0 || b >= Constants::BUCKETS || c <= 0)
+				throw BadParametersException("Bad HalfGCD crossover.");
+			T::consts.HalfGCD_TUNED[b] = c;
+		}
+		if (!in.eof())
+			throw BadParametersException("Bad HalfGCD crossover.");
+	}
 }
@@ -0,0 +1,177 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include <vector>
+
+namespace FAAST {
+	namespace {
+		/* The counters of one thread. They register themselves, so
+		 * that profile() can sum them, and are folded into the
+		 * retired counters when the thread exits.
+		 */
+		struct ThreadCounters {
+			ProbeCounters probes[PROBES];
+			/* nesting level of each probe, to measure only
+			 * the outermost call of recursive kernels */
+			long depth[PROBES];
+			ThreadCounters();
+			~ThreadCounters();
+		};
+
+		volatile bool instrumentation = false;
+		pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+		vector<ThreadCounters*>* registry = NULL;
+		ProbeCounters* retired = NULL;
+		ThreadLocal<ThreadCounters>* volatile counters = NULL;
+
+		/* Create the registry. The registry mutex must be held. */
+		void initRegistry() {
+			if (!registry) {
+				registry = new vector<ThreadCounters*>();
+				retired = new ProbeCounters[PROBES];
+			}
+		}
+
+		ThreadCounters::ThreadCounters() {
+			for (long i = 0 ; i < PROBES ; i++) depth[i] = 0;
+			pthread_mutex_lock(&registryMutex);
+			initRegistry();
+			registry->push_back(this);
+			pthread_mutex_unlock(&registryMutex);
+		}
+
+		ThreadCounters::~ThreadCounters() {
+			pthread_mutex_lock(&registryMutex);
+			for (long i = 0 ; i < PROBES ; i++) retired[i] += probes[i];
+			vector<ThreadCounters*>::iterator it;
+			for (it = registry->begin() ; it != registry->end() ; it++) {
+				if (*it == this) {
+					registry->erase(it);
+					break;
+				}
+			}
+			pthread_mutex_unlock(&registryMutex);
+		}
+
+		ThreadCounters& threadCounters() {
+			if (counters) {
+				memoryBarrier();
+				return counters->get();
+			}
+
+			pthread_mutex_lock(&registryMutex);
+			if (!counters) {
+				ThreadLocal<ThreadCounters>* c = new ThreadLocal<ThreadCounters>();
+				memoryBarrier();
+				counters = c;
+			}
+			pthread_mutex_unlock(&registryMutex);
+			return counters->get();
+		}
+	}
+
+	void ProbeCounters::operator+=(const ProbeCounters& c) throw() {
+		calls += c.calls;
+		time += c.time;
+		if (c.maxtime > maxtime) maxtime = c.maxtime;
+		coefficients += c.coefficients;
+	}
+
+	void setInstrumentation(const bool on) throw() { instrumentation = on; }
+
+	bool getInstrumentation() throw() { return instrumentation; }
+
+	Profile profile() throw() {
+		Profile prof;
+		pthread_mutex_lock(&registryMutex);
+		initRegistry();
+		for (long i = 0 ; i < PROBES ; i++) prof.probes[i] += retired[i];
+		for (unsigned long t = 0 ; t < registry->size() ; t++) {
+			for (long i = 0 ; i < PROBES ; i++)
+				prof.probes[i] += (*registry)[t]->probes[i];
+		}
+		pthread_mutex_unlock(&registryMutex);
+		return prof;
+	}
+
+	Profile threadProfile() throw() {
+		Profile prof;
+		ThreadCounters& c = threadCounters();
+		for (long i = 0 ; i < PROBES ; i++) prof.probes[i] = c.probes[i];
+		return prof;
+	}
+
+	/* The counters of the other threads are written without
+	 * synchronization : see the warning in the declaration. */
+	void resetProfile() throw() {
+		pthread_mutex_lock(&registryMutex);
+		initRegistry();
+		for (long i = 0 ; i < PROBES ; i++) retired[i] = ProbeCounters();
+		for (unsigned long t = 0 ; t < registry->size() ; t++) {
+			for (long i = 0 ; i < PROBES ; i++)
+				(*registry)[t]->probes[i] = ProbeCounters();
+		}
+		pthread_mutex_unlock(&registryMutex);
+	}
+
+	const char* probeName(const Probe p) throw() {
+		static const char* names[PROBES] = {
+			"cyclotomic", "pseudotraces", "liftup", "tracevec",
+			"buildirred", "irredtest", "primetest", "artinmatrix",
+			"buildstem", "pushdownrec", "transpushdownrec",
+			"transposedmul", "transmod", "liftupmul", "bigfrob",
+			"cantor89", "couveignes00", "frobenius", "binomials",
+			"isomorphism"
+		};
+		return (p >= 0 && p < PROBES) ? names[p] : "unknown";
+	}
+
+	void dumpProfile(ostream& out, const Profile& prof) {
+		out << "probe\tcalls\ttime\tmaxtime\tcoefficients" << endl;
+		for (long i = 0 ; i < PROBES ; i++) {
+			const ProbeCounters& c = prof.probes[i];
+			out << probeName(Probe(i)) << "\t" << c.calls << "\t"
+				<< c.time << "\t" << c.maxtime << "\t" << c.coefficients << endl;
+		}
+	}
+
+	ProbeScope::ProbeScope(const Probe p) throw()
+	: probe(p), active(instrumentation), start(0) {
+		if (!active) return;
+		ThreadCounters& c = threadCounters();
+		c.probes[probe].calls++;
+		if (c.depth[probe]++ == 0) start = GetWallTime();
+	}
+
+	ProbeScope::~ProbeScope() throw() {
+		if (!active) return;
+		ThreadCounters& c = threadCounters();
+		if (--c.depth[probe] == 0) {
+			const double t = GetWallTime() - start;
+			c.probes[probe].time += t;
+			if (t > c.probes[probe].maxtime) c.probes[probe].maxtime = t;
+		}
+	}
+
+	void ProbeScope::coefficients(const unsigned long n) throw() {
+		if (active) threadCounters().probes[probe].coefficients += n;
+	}
+}
@@ -21,6 +21,29 @@
 */
 namespace FAAST {
 /****************** Minimal polynomials ******************/
+	/* Balanced product of v[lo], ..., v[hi-1], stored in v[lo].
+	 * The two halves are computed concurrently if parallel is set.
+	 */
+	template <class T> class ConjugatesProductTask : public Task {
+	public:
+		FieldPolynomial<T>* v;
+		long lo, hi;
+		bool parallel;
+
+		ConjugatesProductTask(FieldPolynomial<T>* w, const long l,
+		const long h, const bool par) : v(w), lo(l), hi(h), parallel(par) {}
+
+		void run() {
+			if (hi - lo <= 1) return;
+			const long mid = (lo + hi) / 2;
+			ConjugatesProductTask<T> left(v, lo, mid, parallel);
+			ConjugatesProductTask<T> right(v, mid, hi, parallel);
+			if (parallel) forkJoin(left, right);
+			else { left.run(); right.run(); }
+			v[lo] *= v[mid];
+		}
+	};
+
 	/* All the minimal polynomials up to the field F.
 	 *		res = minimalPolynomials(F);
 	 * res[0] contains minimalPolynomials(F), res[1] contains
@@ -52,14 +75,20 @@ namespace FAAST {
 			}
 		} catch (IllegalCoercionException e) {}
 		// second loop
-		// go down by galois conjugation
+		// go down by galois conjugation : the product of the
+		// conjugates is computed by a balanced tree, whose
+		// branches run in parallel on high enough fields
 		while (G != F.stem) {
-			FieldPolynomial<T> tmp = res[levels];
-			res[levels - 1] = res[levels];
+			vector<FieldPolynomial<T> > conj; conj.resize(G->p);
+			conj[0] = res[levels];
 			for (BigInt i = 1 ; i < G->p ; i++) {
-				tmp.self_frobenius(G->subfield->d);
-				res[levels -1] *= tmp;
+				conj[i] = conj[i-1];
+				conj[i].self_frobenius(G->subfield->d);
 			}
+			ConjugatesProductTask<T> product(&conj[0], 0, conj.size(),
+				getThreads() > 1 && G->height >= getParallelHeight());
+			product.run();
+			res[levels - 1] = conj[0];
 			res[levels - 1] >>= *(G->subfield);
 			G = G->subfield;
 			levels--;
@@ -68,6 +97,160 @@ namespace FAAST {
 		res[0] >>= F;
 	}
 
+	/* Rough costs of the two algorithms computing a minimal polynomial
+	 * of degree m = p^k over a field k levels under an element of height
+	 * h, counted in multiplications in the upper field per coefficient
+	 * of the result:
+	 *  - the conjugates take p-1 frobenius of a polynomial per level,
+	 *    each costing about h push-downs and lift-ups, hence k p h;
+	 *  - the projection takes 2 sqrt(2m) products, pushed down through
+	 *    the k levels, and 2m inner products of length m over the lower
+	 *    field, hence 2 sqrt(2m) (k+1) + 2m.
+	 */
+	inline bool useProjection(const long p, const long k, const long h) {
+		const double m = pow(double(p), double(k));
+		const double projection = 2 * sqrt(2 * m) * (k + 1) + 2 * m;
+		return projection < double(k) * p * h;
+	}
+
+	/* Push down the elements of v, in the stem G, to its subfield F,
+	 * which is also a stem. The m = [G:F] coordinates of v[i] are
+	 * stored in v[i*m], ..., v[i*m + m-1], the top level first: the
+	 * coordinates of the j-th coefficient of the bivariate
+	 * representation over G.subfield occupy the j-th block of m/p.
+	 */
+	template <class T> void pushDownTo(vector<FieldElement<T> >& v,
+	const Field<T>* G, const Field<T>* F) {
+		while (G != F) {
+			vector<FieldElement<T> > w; w.resize(v.size() * long(G->p));
+			pushDownBatch<T>(*G, &v[0], v.size(), &w[0]);
+			v.swap(w);
+			G = G->subfield;
+		}
+	}
+
+	/* The linear form b -> Tr(a*b) down to F, a and b being given by
+	 * the m coordinates over F computed by pushDownTo, so that
+	 *	Tr(a b) = sum res_k b_k.
+	 * Over an Artin-Schreier level X^p - X - c, the trace of x^i is -1
+	 * for i = p-1 and i = 2p-2, and 0 otherwise for i < 2p-1, hence
+	 *	Tr(a b) = - sum_(i+j=p-1) Tr(a_i b_j) - Tr(a_(p-1) b_(p-1)).
+	 * The form of block k is then minus the one of a_(p-1-k), plus minus
+	 * the one of a_(p-1) for k = p-1. It only takes additions.
+	 */
+	template <class T> void traceForm(FieldElement<T>* res,
+	const FieldElement<T>* a, const long m, const long p) {
+		if (m == 1) {
+			res[0] = a[0];
+			return;
+		}
+		const long s = m / p;
+		for (long k = 0 ; k < p ; k++)
+			traceForm(res + k*s, a + (p-1-k)*s, s, p);
+		for (long i = 0 ; i < m ; i++) res[i].negate();
+		for (long i = 0 ; i < s ; i++) res[(p-1)*s + i] += res[i];
+	}
+
+	/* The minimal polynomial over the stem F by power projection.
+	 * This element must be in a stem and not in its subfield, unless
+	 * its parent is F, so that the degree m of the result is the
+	 * degree of its parent over F.
+	 *
+	 * For a random r, the sequence s_i = Tr(r x^i) down to F is
+	 * computed for i < 2m by baby steps-giant steps : the x^t and the
+	 * r x^(bj) are pushed down to F, the linear form Tr(r x^(bj) .) is
+	 * built once per giant step and applied to the baby steps by inner
+	 * products of length m.
+	 * As x generates its parent over F, its minimal polynomial is
+	 * irreducible and the sequence has the same minimal polynomial
+	 * unless it is zero, that is unless r is zero. Berlekamp-Massey
+	 * is done by HalfGCD : the cofactor of
+	 *	A = sum s_i X^(2m-1-i)
+	 * in the first reminder of the euclidean division of X^(2m) by
+	 * A having degree less than m is the minimal polynomial.
+	 */
+	template <class T> void FieldElement<T>::projectionMinimalPolynomial(
+	const Field<T>& F, FieldPolynomial<T>& res) const {
+		const Field<T>* G = parent_field;
+		// minimal polynomial is  (X-this)
+		if (G == &F) {
+			res = -(*this);
+			res.setCoeff(1);
+			return;
+		}
+		const long p = long(G->p);
+		long m = 1;
+		for (long i = F.height ; i < G->height ; i++) m *= p;
+		const long n = 2 * m;
+		const long b = SqrRoot(n - 1) + 1;
+		const long g = (n + b - 1) / b;
+
+		// baby steps
+		vector<FieldElement<T> > baby; baby.resize(b);
+		baby[0] = G->one();
+		for (long t = 1 ; t < b ; t++) baby[t] = baby[t-1] * (*this);
+		const FieldElement<T> xb = baby[b-1] * (*this);
+		pushDownTo(baby, G, &F);
+		// giant steps
+		vector<FieldElement<T> > giant; giant.resize(g);
+		do {
+			giant[0] = G->random();
+		} while (giant[0].isZero());
+		for (long j = 1 ; j < g ; j++) giant[j] = giant[j-1] * xb;
+		pushDownTo(giant, G, &F);
+
+		FieldPolynomial<T> A, P, U0, V0, U1, V1;
+		FieldElement<T> s;
+		vector<FieldElement<T> > form; form.resize(m);
+		A = F.zero();
+		for (long j = 0 ; j < g ; j++) {
+			traceForm(&form[0], &giant[j*m], m, p);
+			for (long t = 0 ; t < b && j*b + t < n ; t++) {
+				s = form[0] * baby[t*m];
+				for (long k = 1 ; k < m ; k++) s += form[k] * baby[t*m + k];
+				A.setCoeff(n - 1 - j*b - t, s);
+			}
+		}
+		P = F.zero();
+		P.setCoeff(n);
+		HalfGCD(U0, V0, U1, V1, P, A, m + 1);
+		res = V1.monic();
+	}
+
+	/* The minimal polynomial over the field F, by the conjugates or by
+	 * power projection, whichever is cheaper.
+	 */
+	template <class T> FieldPolynomial<T> FieldElement<T>::minimalPolynomial(
+	const Field<T>& F, const MinimalPolynomialMethod method)
+	const throw(NotASubFieldException, NotSupportedException) {
+		const Field<T>* G = parent_field->stem;
+		if (!F.isSubFieldOf(*G)) throw NotASubFieldException();
+		if (F.isPrimeField() && !F.isBaseField())
+			throw NotSupportedException();
+
+		// go down as long as this is a member of the subfield,
+		// afterwards the degree of the minimal polynomial is known
+		FieldElement<T> x = *this >> *G;
+		try {
+			while (G != F.stem) {
+				x >>= *(G->subfield);
+				G = G->subfield;
+			}
+		} catch (IllegalCoercionException e) {}
+
+		bool project = method == MINPOL_PROJECTION;
+		if (method == MINPOL_AUTO && G != F.stem)
+			project = useProjection(long(G->p), G->height - F.height, G->height);
+		if (!project) {
+			vector<FieldPolynomial<T> > minpols;
+			x.minimalPolynomials(F, minpols);
+			return minpols[0];
+		}
+		FieldPolynomial<T> res;
+		x.projectionMinimalPolynomial(*(F.stem), res);
+		return res >> F;
+	}
+
 	/* The a-affine minimal polynomial over the field F,
 	 * That is the minimum degree polynomial P of F[X] such that
 	 * 		P(this) = a.
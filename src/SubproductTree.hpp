@@ -0,0 +1,203 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/* Subproduct trees, see e.g. von zur Gathen and Gerhard, Modern
+ * Computer Algebra, Chapter 10.
+ */
+
+namespace FAAST {
+/****************** Tasks ******************/
+	/* Reduction of P down to the leaves under the node i of level k,
+	 * the two subtrees are processed concurrently on big enough
+	 * polynomials.
+	 */
+	template <class T> class SubproductDownTask : public Task {
+	public:
+		const vector<vector<FieldPolynomial<T> > >* tree;
+		const FieldPolynomial<T>* P;
+		long k, i;
+		vector<FieldElement<T> >* values;
+
+		void run() {
+			const vector<vector<FieldPolynomial<T> > >& t = *tree;
+			t[k][i].parent().switchContext();
+			FieldPolynomial<T> R = *P % t[k][i];
+			if (k == 0) {
+				R.getCoeff(0, (*values)[i]);
+				return;
+			}
+			SubproductDownTask<T> left = *this, right = *this;
+			left.P = right.P = &R;
+			left.k = right.k = k - 1;
+			left.i = 2*i; right.i = 2*i + 1;
+			if (right.i >= long(t[k-1].size())) {
+				left.run();
+			} else if (getThreads() > 1 &&
+			           (R.degree() + 1) * R.parent().degree() >= getGrainSize()) {
+				forkJoin(left, right);
+			} else {
+				left.run(); right.run();
+			}
+		}
+	};
+
+	/* The linear combination of the leaves under the node i of
+	 * level k, with coefficients c, stored in res.
+	 */
+	template <class T> class SubproductUpTask : public Task {
+	public:
+		const vector<vector<FieldPolynomial<T> > >* tree;
+		const vector<FieldElement<T> >* c;
+		long k, i;
+		FieldPolynomial<T> res;
+
+		void run() {
+			const vector<vector<FieldPolynomial<T> > >& t = *tree;
+			t[k][i].parent().switchContext();
+			if (k == 0) {
+				res = (*c)[i];
+				return;
+			}
+			SubproductUpTask<T> left, right;
+			left.tree = right.tree = tree;
+			left.c = right.c = c;
+			left.k = right.k = k - 1;
+			left.i = 2*i; right.i = 2*i + 1;
+			if (right.i >= long(t[k-1].size())) {
+				left.run();
+				res = left.res;
+				return;
+			}
+			if (getThreads() > 1 &&
+			    (t[k][i].degree() + 1) * t[k][i].parent().degree() >= getGrainSize()) {
+				forkJoin(left, right);
+			} else {
+				left.run(); right.run();
+			}
+			// res = left * (right subtree) + right * (left subtree)
+			left.res *= t[k-1][right.i];
+			right.res *= t[k-1][left.i];
+			res.sum(left.res, right.res);
+		}
+	};
+
+/****************** Constructors ******************/
+	template <class T> SubproductTree<T>::SubproductTree(const vector<FieldElement<T> >& pts)
+	throw(BadParametersException, UndefinedFieldException, NotInSameFieldException)
+	: field(NULL), points(pts), tree(), weights(), weighted(false), lock() {
+		const long n = points.size();
+		if (n == 0) throw BadParametersException("No points to build a subproduct tree.");
+		// find the field of the points
+		for (long i = 0 ; i < n ; i++) {
+			if (points[i].isZero()) continue;
+			const Field<T>* F = &(points[i].parent());
+			if (!field) field = F;
+			else if (F != field) throw NotInSameFieldException();
+		}
+		for (long i = 0 ; !field && i < n ; i++) {
+			try {
+				field = &(points[i].parent());
+			} catch (UndefinedFieldException e) {}
+		}
+		if (!field) throw UndefinedFieldException();
+
+		// the leaves X - a_i
+		vector<FieldPolynomial<T> > level; level.resize(n);
+		for (long i = 0 ; i < n ; i++) {
+			if (points[i].isZero()) points[i] = field->zero();
+			level[i] = -points[i];
+			level[i].setCoeff(1);
+		}
+		tree.push_back(level);
+		// the products, level by level
+		while (level.size() > 1) {
+			const long m = level.size();
+			vector<FieldPolynomial<T> > above; above.resize((m + 1) / 2);
+			for (long i = 0 ; 2*i < m ; i++) {
+				if (2*i + 1 < m) above[i].product(level[2*i], level[2*i+1]);
+				else above[i] = level[2*i];
+			}
+			level.swap(above);
+			tree.push_back(level);
+		}
+	}
+
+/****************** Evaluation and interpolation ******************/
+	template <class T> void SubproductTree<T>::evaluate(const FieldPolynomial<T>& P,
+	vector<FieldElement<T> >& values) const throw(IllegalCoercionException) {
+		values.clear(); values.resize(points.size());
+		if (P.isZero()) {
+			for (unsigned long i = 0 ; i < values.size() ; i++)
+				values[i] = field->zero();
+			return;
+		}
+		FieldPolynomial<T> Q = P >> *field;
+		SubproductDownTask<T> task;
+		task.tree = &tree;
+		task.P = &Q;
+		task.k = tree.size() - 1;
+		task.i = 0;
+		task.values = &values;
+		task.run();
+	}
+
+	/* Lagrange interpolation: with M the root and w_i = 1/M'(a_i),
+	 *   P = sum v_i w_i M / (X - a_i)
+	 * computed from the leaves up.
+	 */
+	template <class T> void SubproductTree<T>::interpolate(
+	const vector<FieldElement<T> >& values, FieldPolynomial<T>& P)
+	const throw(BadParametersException, IllegalCoercionException) {
+		const long n = points.size();
+		if (long(values.size()) != n)
+			throw BadParametersException("Wrong number of values to interpolate.");
+
+		if (!weighted) {
+			ScopedLock guard(lock);
+			if (!weighted) {
+				vector<FieldElement<T> > w;
+				evaluate(root().derivative(), w);
+				for (long i = 0 ; i < n ; i++) {
+					if (w[i].isZero())
+						throw BadParametersException("The points are not distinct.");
+					w[i].self_inv();
+				}
+				weights.swap(w);
+				memoryBarrier();
+				weighted = true;
+			}
+		} else memoryBarrier();
+
+		vector<FieldElement<T> > c; c.resize(n);
+		for (long i = 0 ; i < n ; i++) {
+			if (values[i].isZero()) c[i] = field->zero();
+			else c[i] = (values[i] >> *field) * weights[i];
+		}
+		SubproductUpTask<T> task;
+		task.tree = &tree;
+		task.c = &c;
+		task.k = tree.size() - 1;
+		task.i = 0;
+		task.run();
+		P = task.res;
+	}
+}
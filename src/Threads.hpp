@@ -0,0 +1,277 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <utility>
+
+namespace FAAST {
+	/* The pool of worker threads, shared by all task groups.
+	 *
+	 * Each worker owns a deque: it pushes the tasks it spawns at the
+	 * back and takes them back from there, while idle workers steal
+	 * the oldest tasks (the largest ones) from the front of the others.
+	 * Tasks spawned by threads outside of the pool go to a shared queue.
+	 *
+	 * The pool is never destroyed, so that workers can safely outlive
+	 * the static objects at exit.
+	 */
+	namespace {
+		typedef pair<Task*, TaskGroup*> Job;
+
+		struct WorkerId {
+			long id;
+			WorkerId() : id(-1) {}
+		};
+
+		pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+		pthread_cond_t poolCond = PTHREAD_COND_INITIALIZER;
+		deque<Job>* poolShared = NULL;
+		vector<deque<Job> >* poolDeques = NULL;
+		ThreadLocal<WorkerId>* poolId = NULL;
+		long poolThreads = 1;
+		long poolRequested = 1;
+		double poolShare = 1;
+		long poolWorkers = 0;
+		long poolGrain = 4096;
+		long poolHeight = 2;
+
+		/* Take a job for worker id (-1 for other threads) : first
+		 * its own newest job, then the oldest shared one, then steal.
+		 * The pool mutex must be held.
+		 */
+		bool takeJob(const long id, Job& job) {
+			if (id >= 0 && !(*poolDeques)[id].empty()) {
+				job = (*poolDeques)[id].back();
+				(*poolDeques)[id].pop_back();
+				return true;
+			}
+			if (!poolShared->empty()) {
+				job = poolShared->front();
+				poolShared->pop_front();
+				return true;
+			}
+			for (long i = 1 ; i <= poolWorkers ; i++) {
+				deque<Job>& victim = (*poolDeques)[(id + i + poolWorkers) % poolWorkers];
+				if (!victim.empty()) {
+					job = victim.front();
+					victim.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/* Take a job of group g queued by the calling thread. The pool
+		 * mutex must be held. Jobs of other groups are never run while
+		 * waiting, so that a thread holding a lock cannot reenter it
+		 * through an unrelated task.
+		 */
+		bool takeJob(const long id, const TaskGroup* g, Job& job) {
+			deque<Job>& queue = id >= 0 ? (*poolDeques)[id] : *poolShared;
+			deque<Job>::reverse_iterator it;
+			for (it = queue.rbegin() ; it != queue.rend() ; it++) {
+				if (it->second == g) {
+					job = *it;
+					queue.erase((it + 1).base());
+					return true;
+				}
+				// the jobs of g are on top of the worker's deque
+				if (id >= 0) break;
+			}
+			return false;
+		}
+	}
+
+	/* Run a task and notify its group. The pool mutex must be
+	 * released when calling this.
+	 */
+	void runTask(Task* t, TaskGroup* g) throw() {
+		bool failed = false;
+		try {
+			t->run();
+		} catch (...) {
+			failed = true;
+		}
+		pthread_mutex_lock(&poolMutex);
+		g->failed = g->failed || failed;
+		g->pending--;
+		pthread_cond_broadcast(&poolCond);
+		pthread_mutex_unlock(&poolMutex);
+	}
+
+	/* The main loop of the workers. Worker number id sleeps while
+	 * there are less than id + 2 threads configured.
+	 */
+	extern "C" void* poolWorker(void* arg) {
+		const long id = long(arg);
+		poolId->get().id = id;
+		Job job;
+		pthread_mutex_lock(&poolMutex);
+		while (true) {
+			if (id >= poolThreads - 1 || !takeJob(id, job)) {
+				pthread_cond_wait(&poolCond, &poolMutex);
+			} else {
+				pthread_mutex_unlock(&poolMutex);
+				runTask(job.first, job.second);
+				pthread_mutex_lock(&poolMutex);
+			}
+		}
+		return NULL;
+	}
+
+	/* Make the pool match the requested number of threads and the
+	 * CPU share. The pool mutex must be held.
+	 */
+	void resizePool() {
+		long n = poolRequested;
+		if (poolShare < 1) n = min(n, max(1L, long(poolShare * hardwareThreads())));
+		if (n > 1 && !poolShared) {
+			poolShared = new deque<Job>();
+			poolDeques = new vector<deque<Job> >();
+			poolId = new ThreadLocal<WorkerId>();
+		}
+		poolThreads = n;
+		if (n > 1 && long(poolDeques->size()) < n - 1) poolDeques->resize(n - 1);
+		while (poolWorkers < n - 1) {
+			pthread_t thread;
+			if (pthread_create(&thread, NULL, poolWorker, (void*) poolWorkers)) break;
+			pthread_detach(thread);
+			poolWorkers++;
+		}
+		pthread_cond_broadcast(&poolCond);
+	}
+
+	void setThreads(const long n)
+	throw(BadParametersException, NotSupportedException) {
+		if (n < 1)
+			throw BadParametersException("The number of threads must be positive.");
+		if (n > 1 && !threadsSupported())
+			throw NotSupportedException("NTL has not been compiled with NTL_THREADS.");
+
+		pthread_mutex_lock(&poolMutex);
+		poolRequested = n;
+		resizePool();
+		pthread_mutex_unlock(&poolMutex);
+	}
+
+	long getThreads() throw() { return poolThreads; }
+
+	void setCPUShare(const double share) throw(BadParametersException) {
+		if (!(share > 0 && share <= 1))
+			throw BadParametersException("The CPU share must be in (0, 1].");
+
+		pthread_mutex_lock(&poolMutex);
+		poolShare = share;
+		resizePool();
+		pthread_mutex_unlock(&poolMutex);
+	}
+
+	double getCPUShare() throw() { return poolShare; }
+
+	long hardwareThreads() throw() {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		return n < 1 ? 1 : n;
+	}
+
+	void setGrainSize(const long g) throw(BadParametersException) {
+		if (g < 1)
+			throw BadParametersException("The grain size must be positive.");
+		poolGrain = g;
+	}
+
+	long getGrainSize() throw() { return poolGrain; }
+
+	void setParallelHeight(const long h) throw(BadParametersException) {
+		if (h < 1)
+			throw BadParametersException("The parallel height must be positive.");
+		poolHeight = h;
+	}
+
+	long getParallelHeight() throw() { return poolHeight; }
+
+	void TaskGroup::spawn(Task& t) {
+		if (poolThreads <= 1) {
+			t.run();
+			return;
+		}
+		const long id = poolId->get().id;
+		pthread_mutex_lock(&poolMutex);
+		if (id >= 0) (*poolDeques)[id].push_back(Job(&t, this));
+		else poolShared->push_back(Job(&t, this));
+		pending++;
+		pthread_cond_broadcast(&poolCond);
+		pthread_mutex_unlock(&poolMutex);
+	}
+
+	void TaskGroup::wait() throw(FAASTException) {
+		const long id = poolId ? poolId->get().id : -1;
+		Job job;
+		pthread_mutex_lock(&poolMutex);
+		while (pending > 0) {
+			if (takeJob(id, this, job)) {
+				pthread_mutex_unlock(&poolMutex);
+				runTask(job.first, job.second);
+				pthread_mutex_lock(&poolMutex);
+			} else {
+				pthread_cond_wait(&poolCond, &poolMutex);
+			}
+		}
+		const bool f = failed;
+		failed = false;
+		pthread_mutex_unlock(&poolMutex);
+		if (f) throw FAASTException("A parallel task has failed.");
+	}
+
+	void forkJoin(Task& a, Task& b) {
+		TaskGroup group;
+		group.spawn(b);
+		a.run();
+		group.wait();
+	}
+
+	TaskGroup::~TaskGroup() throw() {
+		try {
+			wait();
+		} catch (...) {}
+	}
+
+	double GetWallTime() throw() {
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return double(tv.tv_sec) + double(tv.tv_usec) * 1e-6;
+	}
+
+	Mutex::Mutex(const bool recursive) throw() {
+		if (recursive) {
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+			pthread_mutex_init(&mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
+		} else {
+			pthread_mutex_init(&mutex, NULL);
+		}
+	}
+}
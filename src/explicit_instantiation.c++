@@ -29,9 +29,12 @@
 #include "FieldAlgorithms.hpp"
 #include "FieldElement.hpp"
 #include "GCD.hpp"
+#include "Instrumentation.hpp"
 #include "FieldPolynomial.hpp"
 #include "FieldPrecomputations.hpp"
 #include "Minpols.hpp"
+#include "SubproductTree.hpp"
+#include "Threads.hpp"
 #include "utilities.hpp"
 #include "NTLhacks.hpp"
 
@@ -41,16 +44,62 @@ using namespace FAAST;
 template class Field<zz_p_Algebra>;
 template class FieldElement<zz_p_Algebra>;
 template class FieldPolynomial<zz_p_Algebra>;
+template class SubproductTree<zz_p_Algebra>;
 
 template class Field<ZZ_p_Algebra>;
 template class FieldElement<ZZ_p_Algebra>;
 template class FieldPolynomial<ZZ_p_Algebra>;
+template class SubproductTree<ZZ_p_Algebra>;
 
 template class Field<GF2_Algebra>;
 template class FieldElement<GF2_Algebra>;
 template class FieldPolynomial<GF2_Algebra>;
+template class SubproductTree<GF2_Algebra>;
 
 namespace FAAST {
+	template void
+	pushDownBatch<zz_p_Algebra>(const Field<zz_p_Algebra>& K, const FieldElement<zz_p_Algebra>* e,
+			const long n, FieldElement<zz_p_Algebra>* v)
+	throw(NoSubFieldException, NotInSameFieldException);
+	template void
+	pushDownBatch<ZZ_p_Algebra>(const Field<ZZ_p_Algebra>& K, const FieldElement<ZZ_p_Algebra>* e,
+			const long n, FieldElement<ZZ_p_Algebra>* v)
+	throw(NoSubFieldException, NotInSameFieldException);
+	template void
+	pushDownBatch<GF2_Algebra>(const Field<GF2_Algebra>& K, const FieldElement<GF2_Algebra>* e,
+			const long n, FieldElement<GF2_Algebra>* v)
+	throw(NoSubFieldException, NotInSameFieldException);
+
+	template void
+	liftUpBatch<zz_p_Algebra>(const Field<zz_p_Algebra>& K, const FieldElement<zz_p_Algebra>* v,
+			const long n, FieldElement<zz_p_Algebra>* e)
+	throw(NotInSameFieldException, NoOverFieldException);
+	template void
+	liftUpBatch<ZZ_p_Algebra>(const Field<ZZ_p_Algebra>& K, const FieldElement<ZZ_p_Algebra>* v,
+			const long n, FieldElement<ZZ_p_Algebra>* e)
+	throw(NotInSameFieldException, NoOverFieldException);
+	template void
+	liftUpBatch<GF2_Algebra>(const Field<GF2_Algebra>& K, const FieldElement<GF2_Algebra>* v,
+			const long n, FieldElement<GF2_Algebra>* e)
+	throw(NotInSameFieldException, NoOverFieldException);
+
+	template void
+	invertBatch<zz_p_Algebra>(FieldElement<zz_p_Algebra>* e, const long n,
+			vector<long>& zeros) throw(NotInSameFieldException);
+	template void
+	invertBatch<ZZ_p_Algebra>(FieldElement<ZZ_p_Algebra>* e, const long n,
+			vector<long>& zeros) throw(NotInSameFieldException);
+	template void
+	invertBatch<GF2_Algebra>(FieldElement<GF2_Algebra>* e, const long n,
+			vector<long>& zeros) throw(NotInSameFieldException);
+
+	template void
+	invertBatch<zz_p_Algebra>(FieldPolynomial<zz_p_Algebra>& P, vector<long>& zeros) throw();
+	template void
+	invertBatch<ZZ_p_Algebra>(FieldPolynomial<ZZ_p_Algebra>& P, vector<long>& zeros) throw();
+	template void
+	invertBatch<GF2_Algebra>(FieldPolynomial<GF2_Algebra>& P, vector<long>& zeros) throw();
+
 	template FieldPolynomial<zz_p_Algebra>
 	GCD<zz_p_Algebra>(const FieldPolynomial<zz_p_Algebra>& P,
 			const FieldPolynomial<zz_p_Algebra>& Q) throw(NotInSameFieldException);
@@ -79,4 +128,54 @@ namespace FAAST {
 			const FieldPolynomial<GF2_Algebra>& P, const FieldPolynomial<GF2_Algebra>& Q,
 			const long d)
 	throw(NotInSameFieldException, BadParametersException);
+
+	template long
+	tuneHalfGCD<zz_p_Algebra>(const Field<zz_p_Algebra>& K, const char* file)
+	throw(BadParametersException);
+	template long
+	tuneHalfGCD<ZZ_p_Algebra>(const Field<ZZ_p_Algebra>& K, const char* file)
+	throw(BadParametersException);
+	template long
+	tuneHalfGCD<GF2_Algebra>(const Field<GF2_Algebra>& K, const char* file)
+	throw(BadParametersException);
+
+	template void
+	compose<zz_p_Algebra>(zz_p_Algebra::GFpX& res, const zz_p_Algebra::GFpX& Q,
+			const zz_p_Algebra::GFpX& R, const zz_p_Algebra::BigInt& p);
+	template void
+	compose<ZZ_p_Algebra>(ZZ_p_Algebra::GFpX& res, const ZZ_p_Algebra::GFpX& Q,
+			const ZZ_p_Algebra::GFpX& R, const ZZ_p_Algebra::BigInt& p);
+	template void
+	compose<GF2_Algebra>(GF2_Algebra::GFpX& res, const GF2_Algebra::GFpX& Q,
+			const GF2_Algebra::GFpX& R, const GF2_Algebra::BigInt& p);
+
+	template void
+	taylorShift<zz_p_Algebra>(zz_p_Algebra::GFpX& res, const zz_p_Algebra::GFpX& Q,
+			const long c, const zz_p_Algebra::BigInt& p);
+	template void
+	taylorShift<ZZ_p_Algebra>(ZZ_p_Algebra::GFpX& res, const ZZ_p_Algebra::GFpX& Q,
+			const long c, const ZZ_p_Algebra::BigInt& p);
+	template void
+	taylorShift<GF2_Algebra>(GF2_Algebra::GFpX& res, const GF2_Algebra::GFpX& Q,
+			const long c, const GF2_Algebra::BigInt& p);
+
+	template void
+	artinSchreierCompose<zz_p_Algebra>(zz_p_Algebra::GFpX& res, const zz_p_Algebra::GFpX& Q,
+			const zz_p_Algebra::BigInt& p);
+	template void
+	artinSchreierCompose<ZZ_p_Algebra>(ZZ_p_Algebra::GFpX& res, const ZZ_p_Algebra::GFpX& Q,
+			const ZZ_p_Algebra::BigInt& p);
+	template void
+	artinSchreierCompose<GF2_Algebra>(GF2_Algebra::GFpX& res, const GF2_Algebra::GFpX& Q,
+			const GF2_Algebra::BigInt& p);
+
+	template void saveHalfGCDCrossovers<zz_p_Algebra>(ostream& o);
+	template void saveHalfGCDCrossovers<ZZ_p_Algebra>(ostream& o);
+	template void saveHalfGCDCrossovers<GF2_Algebra>(ostream& o);
+	template void loadHalfGCDCrossovers<zz_p_Algebra>(istream& in)
+	throw(BadParametersException);
+	template void loadHalfGCDCrossovers<ZZ_p_Algebra>(istream& in)
+	throw(BadParametersException);
+	template void loadHalfGCDCrossovers<GF2_Algebra>(istream& in)
+	throw(BadParametersException);
 }
@@ -107,6 +107,115 @@ namespace FAAST {
 		}
 	}
 
+	/* Store in res the polynomial Q(X + c), c = 1 or -1.
+	 *
+	 * In characteristic p, (X + c)^(p^k) = X^(p^k) + c. So, seeing
+	 * Q as a polynomial in X^(p^k) with coefficients blocks of
+	 * size p^k, one level of the shift is a classic Taylor shift
+	 * by c over the blocks, that only needs additions. The levels
+	 * are processed bottom-up, in place.
+	 */
+	template <class T> void taylorShift(typename T::GFpX& res,
+	const typename T::GFpX& Q, const long c, const typename T::BigInt& p) {
+		typedef typename T::GFp GFp;
+		typedef typename T::GFpX GFpX;
+
+		const long n = deg(Q) + 1;
+		if (n <= 1) { res = Q; return; }
+		const long q = long(p);
+
+		vector<GFp> a; a.resize(n);
+		for (long i = 0 ; i < n ; i++) a[i] = coeff(Q, i);
+
+		for (long m = 1 ; m < n ; m *= q) {
+			for (long s = 0 ; s < n ; s += q*m) {
+				// number of non-zero blocks in this superblock,
+				// the shift does not make it grow
+				const long b = min(q, (n - s + m - 1) / m);
+				for (long i = 0 ; i < b-1 ; i++) {
+					for (long j = b-2 ; j >= i ; j--) {
+						const long lo = s + j*m, hi = lo + m;
+						const long len = min(m, n - hi);
+						if (c > 0)
+							for (long h = 0 ; h < len ; h++) a[lo+h] += a[hi+h];
+						else
+							for (long h = 0 ; h < len ; h++) a[lo+h] -= a[hi+h];
+					}
+				}
+			}
+		}
+
+		GFpX restmp;
+		SetCoeff(restmp, n-1); // hack, the degree does not change
+		for (long i = 0 ; i < n ; i++) SetCoeff(restmp, i, a[i]);
+		res = restmp;
+	}
+
+	/* Store in out[0 .. p*len) the composition with X^p - X of the
+	 * block Q[start .. start+len). len is a power of p and out must
+	 * be zero on entry. With Y = X^p - X and m = len/p, the block is
+	 * split as sum B_i Y^(i m) and Y^m = X^(p m) - X^m, so Horner's
+	 * rule only needs a shift-subtract in place. Each level of the
+	 * recursion has its own buffer in scratch.
+	 */
+	template <class T> void artinSchreierComposeRec(vector<typename T::GFp>& out,
+	const vector<typename T::GFp>& Q, const long start, const long len,
+	const long p, vector<vector<typename T::GFp> >& scratch, const long level) {
+		typedef typename T::GFp GFp;
+
+		if (len == 1) { out[0] = Q[start]; return; }
+		const long m = len / p, width = p*m;
+		const long n = Q.size();
+		vector<GFp>& B = scratch[level];
+		long used = 0;
+		for (long i = p-1 ; i >= 0 ; i--) {
+			// acc *= X^(p m) - X^m
+			if (used > 0) {
+				for (long k = used + width - 1 ; k >= 0 ; k--) {
+					GFp v;
+					if (k >= width) v = out[k - width];
+					if (k >= m && k - m < used) v -= out[k - m];
+					out[k] = v;
+				}
+				used += width;
+			}
+			// acc += B_i(Y)
+			if (start + i*m >= n) continue;
+			for (long k = 0 ; k < width ; k++) clear(B[k]);
+			artinSchreierComposeRec<T>(B, Q, start + i*m, m, p, scratch, level+1);
+			for (long k = 0 ; k < width ; k++) out[k] += B[k];
+			used = max(used, width);
+		}
+	}
+
+	/* Store in res the composition Q(X^p - X) */
+	template <class T> void artinSchreierCompose(typename T::GFpX& res,
+	const typename T::GFpX& Q, const typename T::BigInt& p) {
+		typedef typename T::GFp GFp;
+		typedef typename T::GFpX GFpX;
+
+		const long n = deg(Q) + 1;
+		if (n <= 1) { res = Q; return; }
+		const long q = long(p);
+
+		vector<GFp> a; a.resize(n);
+		for (long i = 0 ; i < n ; i++) a[i] = coeff(Q, i);
+		// pad the degree to a power of p
+		long N = 1, levels = 0;
+		while (N < n) { N *= q; levels++; }
+		vector<vector<GFp> > scratch; scratch.resize(levels);
+		for (long l = 0, m = N/q ; l < levels ; l++, m /= q)
+			scratch[l].resize(q*m);
+		vector<GFp> out; out.resize(q*N);
+		artinSchreierComposeRec<T>(out, a, 0, N, q, scratch, 0);
+
+		GFpX restmp;
+		const long top = q*(n-1);
+		SetCoeff(restmp, top); // hack, Q(X^p - X) is of degree p deg(Q)
+		for (long i = 0 ; i <= top ; i++) SetCoeff(restmp, i, out[i]);
+		res = restmp;
+	}
+
 	/* Brent variant of Pollard Rho. Returns 0 or a
 	 * factor of n.
 	 */
@@ -48,17 +48,16 @@ int main(int argv, char* argc[]) {
 	}
 
 	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
 	cputime = -NTL::GetTime();
 	const gfp* K = &(gfp::createField(p,d));
 	cputime += NTL::GetTime();
 	cout << *K << " in " << cputime << endl;
-#ifdef FAAST_TIMINGS
 	cout << "Time spent building the irreducible polynomial : "
-		<< gfp::TIME.BUILDIRRED << endl;
-#endif
+		<< profile()[PROBE_BUILDIRRED].time << endl;
 	cout << endl;
 
-	cout << "\tCreate\tMinPol\tInterp\tEval" << endl;
+	cout << "\tCreate\tMinPol\tMinProj\tInterp\tEval" << endl;
 	for (int i = 1 ; i <= l ; i++) {
 		cout << i << "\t";
 		cputime = -NTL::GetTime();
@@ -76,6 +75,16 @@ int main(int argv, char* argc[]) {
 		cputime += NTL::GetTime();
 		cout << cputime << "\t";
 
+		cputime = -NTL::GetTime();
+		gfp_X projected = a.minimalPolynomial(K->baseField(), gfp_E::MINPOL_PROJECTION);
+		cputime += NTL::GetTime();
+		cout << cputime << "\t";
+		if (projected != minpols[0]) {
+			cout << "ERROR 0 : Minimal polynomials don't match" << endl;
+			cout << minpols[0] << endl << projected << endl;
+			retval = 1;
+		}
+
 		gfp_X poly;
 		bool nopol = false;
 		cputime = -NTL::GetTime();
@@ -0,0 +1,151 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+/**
+	\example testCantor.c++
+	This example measures the construction of Artin-Schreier towers,
+	timing the product of the 2p-1 twisted copies of the defining
+	polynomial in Cantor's algorithm, and checks that the towers built
+	sequentially and in parallel agree with the linear product.
+*/
+
+#include <faast.hpp>
+#include <FAAST/utilities.hpp>
+#include <cstdlib>
+
+using namespace std;
+using namespace FAAST;
+
+typedef zz_p_Algebra::GFpX  GFpX;
+typedef zz_p_Algebra::GFpE  GFpE;
+typedef zz_p_Algebra::GFpEX GFpEX;
+typedef Field<zz_p_Algebra> gfp;
+
+/* The 2p-1 factors Q(omega^i Y) of Cantor's algorithm.
+ * The modulus must be the (2p-1)-th cyclotomic polynomial.
+ */
+void twisted(vector<GFpEX>& factors, const GFpX& Q, const long p) {
+	GFpE omega; GFpX omegaX; SetX(omegaX); conv(omega, omegaX);
+	vector<GFpE> omegas(2*p-1);
+	omegas[0] = 1;
+	for (long i = 1 ; i <= 2*p-2 ; i++) omegas[i] = omegas[i-1]*omega;
+
+	factors.resize(2*p-1);
+	for (long i = 0 ; i <= 2*p-2 ; i++) {
+		long c = 0;
+		for (long j = 0 ; j <= deg(Q) ; j++) {
+			SetCoeff(factors[i], j, coeff(Q, j) * omegas[c]);
+			c += i; c %= 2*p - 1;
+		}
+	}
+}
+
+int main(int argv, char* argc[]) {
+	double cputime;
+	int retval = 0;
+
+	long p, d, l, t = 4;
+	if (cin.peek() != EOF) {
+	  cin >> p; cin >> d; cin >> l;
+	  if (!(cin >> t)) t = 4;
+	} else {
+	  p = 11; d = 1; l = 3;
+	}
+	if (!threadsSupported()) t = 1;
+
+	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
+	const gfp* K = &(gfp::createField(p,d));
+	const gfp* C = &(gfp::createField(p,d));
+	cout << *K << endl << endl;
+
+	cout << "\tLinear\tCantor\tBuild\tCantor\tBuild\t(" << t << " threads)" << endl;
+	for (long i = 1 ; i <= l ; i++) {
+		cout << i << "\t";
+
+		// Cantor's algorithm is used from height 1 on (2 in characteristic 2)
+		// the next defining polynomial is then qstar(X^p - X), where
+		// qstar(Y^(2p-1)) is the product of the twisted factors; the
+		// composition is checked against the generic compose()
+		bool cantor = K->height >= 1 && !(K->height == 1 && p == 2);
+		GFpX expected;
+		if (cantor) {
+			K->switchContext();
+			GFpX Q = GFpE::modulus().val();
+			GFpX Phi; cyclotomic<zz_p_Algebra>(Phi, 2*p-1, p);
+			GFpE::init(Phi);
+
+			vector<GFpEX> linear;
+			twisted(linear, Q, p);
+			cputime = -GetTime();
+			for (long j = 1 ; j <= 2*p-2 ; j++) linear[0] *= linear[j];
+			cputime += GetTime();
+			cout << cputime << "\t";
+
+			GFpX qstar;
+			for (long j = 0 ; j <= deg(linear[0]) ; j += 2*p-1)
+				SetCoeff(qstar, j / (2*p-1), ConstTerm(rep(coeff(linear[0], j))));
+			GFpX R; SetCoeff(R, p); SetCoeff(R, 1, -1);
+			compose<zz_p_Algebra>(expected, qstar, R, p);
+		} else {
+			cout << "-\t";
+		}
+
+		// build the level twice : sequentially in a copy of the tower,
+		// then with t threads, splitting down to the smallest products
+		// so that small towers go through the parallel branches too
+		Profile before = profile();
+		cputime = -GetWallTime();
+		C = &(C->ArtinSchreierExtension());
+		cputime += GetWallTime();
+		cout << profile()[PROBE_CANTOR89].time - before[PROBE_CANTOR89].time
+			<< "\t" << cputime << "\t";
+
+		const long grain = getGrainSize();
+		setThreads(t);
+		setGrainSize(1);
+		before = profile();
+		cputime = -GetWallTime();
+		K = &(K->ArtinSchreierExtension());
+		cputime += GetWallTime();
+		setGrainSize(grain);
+		setThreads(1);
+		cout << profile()[PROBE_CANTOR89].time - before[PROBE_CANTOR89].time
+			<< "\t" << cputime << endl;
+
+		// both towers must have the same defining polynomials,
+		// given by the linear product when Cantor's algorithm is used
+		C->switchContext();
+		GFpX QC = GFpE::modulus().val();
+		K->switchContext();
+		GFpX QK = GFpE::modulus().val();
+		if (QC != QK) {
+			cout << "ERROR : the sequential and parallel towers differ" << endl;
+			retval = 1;
+		}
+		if (cantor && QK != expected) {
+			cout << "ERROR : the defining polynomial doesn't match the product" << endl;
+			retval = 1;
+		}
+	}
+
+	return retval;
+}
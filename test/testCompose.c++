@@ -0,0 +1,111 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include <faast.hpp>
+#include <FAAST/utilities.hpp>
+#include <cstdlib>
+
+using namespace std;
+using namespace FAAST;
+
+typedef Field<ZZ_p_Algebra> GFp;
+typedef Field<zz_p_Algebra> gfp;
+typedef Field<GF2_Algebra>  GFp2;
+
+/* Compare taylorShift() and artinSchreierCompose() with compose() on
+ * random polynomials of degree 0, 1 and around the powers of p.
+ * Returns the number of mismatches.
+ */
+template <class T> long check(const Field<T>& K) {
+	typedef typename T::GFpX GFpX;
+
+	K.switchContext();
+	const typename T::BigInt p = K.characteristic();
+	const long q = long(p);
+
+	vector<long> degrees;
+	degrees.push_back(0);
+	degrees.push_back(1);
+	for (long k = 1, pk = q ; k <= 3 ; k++, pk *= q) {
+		degrees.push_back(pk - 1);
+		degrees.push_back(pk);
+		degrees.push_back(pk + 1);
+	}
+	degrees.push_back(2*q*q + 3);
+
+	GFpX plus, minus, AS;
+	SetCoeff(plus, 1); SetCoeff(plus, 0, 1);
+	SetCoeff(minus, 1); SetCoeff(minus, 0, -1);
+	SetCoeff(AS, q); SetCoeff(AS, 1, -1);
+
+	long errors = 0;
+	for (unsigned long i = 0 ; i < degrees.size() ; i++) {
+		const long n = degrees[i];
+		GFpX Q, expected, res;
+		random(Q, n + 1);
+		SetCoeff(Q, n);
+
+		compose<T>(expected, Q, plus, p);
+		taylorShift<T>(res, Q, 1, p);
+		if (res != expected) {
+			cout << "ERROR : Q(X+1) is wrong in degree " << n << endl;
+			errors++;
+		}
+		compose<T>(expected, Q, minus, p);
+		taylorShift<T>(res, Q, -1, p);
+		if (res != expected) {
+			cout << "ERROR : Q(X-1) is wrong in degree " << n << endl;
+			errors++;
+		}
+		compose<T>(expected, Q, AS, p);
+		artinSchreierCompose<T>(res, Q, p);
+		if (res != expected) {
+			cout << "ERROR : Q(X^p-X) is wrong in degree " << n << endl;
+			errors++;
+		}
+	}
+	return errors;
+}
+
+int main(int argv, char* argc[]) {
+	int retval = 0;
+
+	const GFp& K = GFp::createField(to_ZZ(3),1);
+	const gfp& k = gfp::createField(5,1);
+	const GFp2& L = GFp2::createField(2,1);
+
+	cout << "ZZ_p\t" << K.characteristic() << "\t";
+	long errors = check(K);
+	cout << (errors ? "failed" : "ok") << endl;
+	if (errors) retval = 1;
+
+	cout << "zz_p\t" << k.characteristic() << "\t";
+	errors = check(k);
+	cout << (errors ? "failed" : "ok") << endl;
+	if (errors) retval = 1;
+
+	cout << "GF2\t" << L.characteristic() << "\t";
+	errors = check(L);
+	cout << (errors ? "failed" : "ok") << endl;
+	if (errors) retval = 1;
+
+	return retval;
+}
@@ -21,6 +21,7 @@
 */
 #include <faast.hpp>
 #include <cstdlib>
+#include <sstream>
 
 namespace FAAST {
 	template <class T> void
@@ -69,6 +70,19 @@ int main(int argv, char* argc[]) {
 		cout << t << "\t" << cputime << endl;
 		cout.flush();
 	}
+
+	// the measured crossover survives a save and load
+	const long c = tuneHalfGCD(K);
+	cout << "Tuned crossover : " << c << endl;
+	stringstream saved;
+	saveHalfGCDCrossovers<GFp::Infrastructure>(saved);
+	GFp::Infrastructure::consts.HalfGCD_TUNED[Constants::bucket(n)] = 0;
+	loadHalfGCDCrossovers<GFp::Infrastructure>(saved);
+	if (GFp::Infrastructure::consts.halfGCDCrossover(n) != c) {
+		cout << "ERROR : Crossover not restored" << endl;
+		return 1;
+	}
+	return 0;
 /*
 	P1 = P; Q1 = Q;
 	cputime = -NTL::GetTime();
@@ -29,6 +29,7 @@
 
 #include <faast.hpp>
 #include <cstdlib>
+#include <sstream>
 
 using namespace std;
 using namespace FAAST;
@@ -49,19 +50,20 @@ int main(int argv, char* argc[]) {
 	}
 
 	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
 	cputime = -NTL::GetTime();
 	const gfp* K = &(gfp::createField(p,d));
 	cputime += NTL::GetTime();
 	cout << *K << " in " << cputime << endl;
-#ifdef FAAST_TIMINGS
 	cout << "Time spent building the irreducible polynomial : "
-		<< gfp::TIME.BUILDIRRED << endl;
-#endif
+		<< profile()[PROBE_BUILDIRRED].time << endl;
 	cout << endl;
 
 	cout << "\tCreate\tCrStem\tPushDow\tLiftUp\tPrePseu\tPreLift" << endl;
 	for (int i = 1 ; i <= l ; i++) {
 		cout << i << "\t";
+		// the precomputations done at this level
+		const Profile before = profile();
 		gfp_E alpha;
 		do {
 			alpha = K->random();
@@ -70,9 +72,7 @@ int main(int argv, char* argc[]) {
 		K = &(K->ArtinSchreierExtension(alpha));
 		cputime += NTL::GetTime();
 		cout << cputime << "\t";
-#ifdef FAAST_TIMINGS
-		cout << gfp::TIME.BUILDSTEM;
-#endif
+		cout << profile()[PROBE_BUILDSTEM].time - before[PROBE_BUILDSTEM].time;
 		cout << "\t";
 
 		const gfp& L = K->stemField().subField();
@@ -99,16 +99,65 @@ int main(int argv, char* argc[]) {
 			retval = 1;
 		}
 
-#ifdef FAAST_TIMINGS
-		cout << gfp::TIME.PSEUDOTRACES << "\t";
-		cout << gfp::TIME.LIFTUP;
-#endif
+		const Profile after = profile();
+		cout << after[PROBE_PSEUDOTRACES].time - before[PROBE_PSEUDOTRACES].time << "\t";
+		cout << after[PROBE_LIFTUP].time - before[PROBE_LIFTUP].time;
 		cout << endl;
 	}
-#ifdef FAAST_TIMINGS
-	cout << endl << "Time spent inverting the matrix " <<
-		gfp::TIME.ARTINMATRIX << endl;
-#endif
+
+	// a copy of the last level out of the stem
+	if (l >= 1) {
+		const gfp& L = K->stemField().subField();
+		gfp_E alpha;
+		do {
+			alpha = L.random();
+		} while (alpha.trace() == 0);
+		const gfp& M = L.ArtinSchreierExtension(alpha);
+		M.precompute(gfp::ISOMORPHISM);
+		vector<gfp_E> v;
+		gfp_E a = M.random(), b;
+		cputime = -NTL::GetTime();
+		L.toBivariate(a, v);
+		cputime += NTL::GetTime();
+		cout << endl << "Push down out of the stem in " << cputime << endl;
+		cputime = -NTL::GetTime();
+		M.toUnivariate(v, b);
+		cputime += NTL::GetTime();
+		cout << "Lift up out of the stem in " << cputime << endl;
+		if (a != b) {
+			cout << "ERROR : Results don't match out of the stem" << endl;
+			retval = 1;
+		}
+	}
+	cout << endl << "Time spent factoring the matrix " <<
+		profile()[PROBE_ARTINMATRIX].time << endl;
+
+	// the matrix can be saved and loaded back in a new field with
+	// the same defining polynomial, and both solvers find roots
+	if (d > 1) {
+		const gfp& B = K->baseField();
+		stringstream saved;
+		B.saveArtinMatrix(saved);
+		try {
+			B.loadArtinMatrix(saved);
+			cout << "ERROR : the Artin matrix was loaded twice" << endl;
+			retval = 1;
+		} catch (BadParametersException e) {}
+		saved.seekg(0);
+		B.switchContext();
+		const gfp& F = gfp::createField(ZZ_pE::modulus().val(), false);
+		F.loadArtinMatrix(saved);
+		gfp_E c = F.random();
+		gfp_E beta = c.frobenius() - c;
+		gfp_E r1 = F.Couveignes2000(beta);
+		F.setArtinSolver(gfp::ARTIN_INVERSE);
+		gfp_E r2 = F.Couveignes2000(beta);
+		F.setArtinSolver(gfp::ARTIN_LU);
+		if (r1.frobenius() - r1 != beta || r2.frobenius() - r2 != beta) {
+			cout << "ERROR : Artin-Schreier roots are wrong" << endl;
+			retval = 1;
+		}
+	}
 
 	return retval;
 }
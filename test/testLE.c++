@@ -47,17 +47,16 @@ int main(int argv, char* argc[]) {
 	}
 
 	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
 	cputime = -NTL::GetTime();
 	const gfp* K = &(gfp::createField(p,d));
 	cputime += NTL::GetTime();
 	cout << *K << " in " << cputime << endl;
-#ifdef FAAST_TIMINGS
 	cout << "Time spent building the irreducible polynomial : "
-		<< gfp::TIME.BUILDIRRED << endl;
-#endif
+		<< profile()[PROBE_BUILDIRRED].time << endl;
 	cout << endl;
 
-	cout << "\tPDown\tLUp\tLUPre" << endl;
+	cout << "\tPDown\tLUp\tLUPre\tTMul\tTMod\tTPDRec\tLUMul" << endl;
 	for (int i = 1 ; i <= l ; i++) {
 		cputime = -NTL::GetTime();
 		K = &(K->ArtinSchreierExtension());
@@ -73,13 +72,19 @@ int main(int argv, char* argc[]) {
 			cputime += GetTime();
 			cout << cputime << "\t";
 
+			const Profile before = profile();
 			cputime = -GetTime();
 			liftUp(down, b);
 			cputime += GetTime();
 			cout << cputime << "\t";
-#ifdef FAAST_TIMINGS
-			cout << gfp::TIME.LIFTUP;
-#endif
+			// the phases of this lift-up
+			const Profile after = profile();
+			const Probe phases[] = { PROBE_LIFTUP, PROBE_TRANSPOSEDMUL,
+				PROBE_TRANSMOD, PROBE_TRANSPUSHDOWNREC, PROBE_LIFTUPMUL };
+			for (int j = 0 ; j < 5 ; j++) {
+				cout << after[phases[j]].time - before[phases[j]].time;
+				if (j < 4) cout << "\t";
+			}
 
 			if (a != b) {
 			  cout << endl << "ERROR : Results don't match" << endl;
@@ -92,12 +97,33 @@ int main(int argv, char* argc[]) {
 			}
 			cout << endl;
 		}
+
+		/** Batched Push-down / Lift-up **/
+		const long n = 64;
+		const gfp& k = K->subField();
+		const long w = K->degree() / k.degree();
+		vector<gfp_E> a(n), down(n * w), b(n);
+		for (long j = 0 ; j < n ; j++) a[j] = K->random();
+
+		double pdtime = -GetWallTime();
+		pushDownBatch(*K, &a[0], n, &down[0]);
+		pdtime += GetWallTime();
+		double lutime = -GetWallTime();
+		liftUpBatch(k, &down[0], n, &b[0]);
+		lutime += GetWallTime();
+		cout << "Batch of " << n << " : " << n / pdtime << " PDown/s\t"
+			<< n / lutime << " LUp/s" << endl;
+		if (a != b) {
+			cout << "ERROR : Batched results don't match" << endl;
+			retval = 1;
+		}
 	}
 
-#ifdef FAAST_TIMINGS
 	cout << endl << "Time spent building the cyclotomic polynomial : "
-		<< gfp::TIME.CYCLOTOMIC << endl;
-#endif
-	
+		<< profile()[PROBE_CYCLOTOMIC].time << endl;
+
+	cout << endl << "Profile :" << endl;
+	dumpProfile(cout, profile());
+
 	return retval;
 }
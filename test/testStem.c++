@@ -39,28 +39,30 @@ int main(int argv, char* argc[]) {
 	int retval = 0;
 
 	gfp::Infrastructure::BigInt p;
-	long d, l;
+	long d, l, t = 4;
 	if (cin.peek() != EOF) {
 	  cin >> p; cin >> d; cin >> l;
+	  if (!(cin >> t)) t = 4;
 	} else {
 	  p = 2; d = 1; l = 4;
 	}
+	if (!threadsSupported()) t = 1;
 
 	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
 	cputime = -NTL::GetTime();
 	const gfp* K = &(gfp::createField(p,d));
 	cputime += NTL::GetTime();
 	cout << *K << " in " << cputime << endl;
-#ifdef FAAST_TIMINGS
 	cout << "Time spent building the irreducible polynomial : "
-		<< gfp::TIME.BUILDIRRED << endl;
-#endif
+		<< profile()[PROBE_BUILDIRRED].time << endl;
 	cout << endl;
 
-	cout << "\tCreate\tPushDow\tLiftUp\tPreLift\tMul\tInv" << endl;
+	cout << "\tCreate\tPushDow\tLiftUp\tPreLift\tMul\tInv\tItInv" << endl;
 	totaltime = -GetTime();
 	for (int i = 1 ; i <= l ; i++) {
 		cout << i << "\t";
+		const Profile before = profile();
 		/** Construction **/
 		cputime = -NTL::GetTime();
 		K = &(K->ArtinSchreierExtension());
@@ -80,9 +82,7 @@ int main(int argv, char* argc[]) {
 		liftUp(down, b);
 		cputime += GetTime();
 		cout << cputime << "\t";
-#ifdef FAAST_TIMINGS
-		cout << gfp::TIME.LIFTUP;
-#endif
+		cout << profile()[PROBE_LIFTUP].time - before[PROBE_LIFTUP].time;
 		cout << "\t";
 
 		if (a != b) {
@@ -102,19 +102,102 @@ int main(int argv, char* argc[]) {
 		cout << cputime << "\t";
 
 		/** Inversion **/
+		gfp_E c, e;
 		cputime = -GetTime();
-		if (a != 0) a.inv();
+		if (a != 0) c = a.inv(gfp_E::INV_XGCD);
+		cputime += GetTime();
+		cout << cputime << "\t";
+
+		cputime = -GetTime();
+		if (a != 0) e = a.inv(gfp_E::INV_ITOH_TSUJII);
 		cputime += GetTime();
 		cout << cputime << endl;
+
+		if (c != e) {
+			cout << "ERROR : Inverses don't match" << endl;
+			cout << c << endl << e << endl;
+			retval = 1;
+		}
+
+		// batch inversion reports the zeros instead of throwing
+		vector<gfp_E> batch; batch.resize(8);
+		vector<long> zeros;
+		for (long j = 0 ; j < 8 ; j++)
+			batch[j] = (j == 3) ? K->zero() : K->random();
+		vector<gfp_E> orig = batch;
+		invertBatch(&batch[0], batch.size(), zeros);
+		for (long j = 0 ; j < 8 ; j++) {
+			if (orig[j] != 0 && batch[j] * orig[j] != 1) {
+				cout << "ERROR : Batch inverse is wrong" << endl;
+				retval = 1;
+			}
+		}
+		bool found = false;
+		for (long j = 0 ; j < long(zeros.size()) ; j++) {
+			found = found || zeros[j] == 3;
+			if (orig[zeros[j]] != 0) found = false;
+		}
+		if (!found) {
+			cout << "ERROR : Zeros wrongly reported by batch inversion" << endl;
+			retval = 1;
+		}
 	}
 	totaltime += GetTime();
 
-#ifdef FAAST_TIMINGS
+	/** Parallel Push-down / Lift-up **/
+	if (t > 1) {
+		gfp_E a = K->random(), b, c;
+		vector<gfp_E> seq, par;
+		double seqtime[2], partime[2];
+
+		// warm the precomputations, so that both runs use them
+		setThreads(t);
+		cputime = -GetWallTime();
+		K->precompute();
+		cputime += GetWallTime();
+		setThreads(1);
+		cout << endl << "Precomputations (" << t << " threads) : "
+			<< cputime << endl;
+
+		seqtime[0] = -GetWallTime();
+		pushDown(a, seq);
+		seqtime[0] += GetWallTime();
+		seqtime[1] = -GetWallTime();
+		liftUp(seq, b);
+		seqtime[1] += GetWallTime();
+
+		// split down to the smallest pieces, so that small towers
+		// go through the parallel branches too
+		const long grain = getGrainSize();
+		setThreads(t);
+		setGrainSize(1);
+		partime[0] = -GetWallTime();
+		pushDown(a, par);
+		partime[0] += GetWallTime();
+		partime[1] = -GetWallTime();
+		liftUp(par, c);
+		partime[1] += GetWallTime();
+		setGrainSize(grain);
+		setThreads(1);
+
+		cout << endl << "\tPushDow\tLiftUp\t(" << t << " threads)" << endl;
+		cout << "Seq\t" << seqtime[0] << "\t" << seqtime[1] << endl;
+		cout << "Par\t" << partime[0] << "\t" << partime[1] << endl;
+		cout << "Speedup\t" << seqtime[0] / partime[0] << "\t"
+			<< seqtime[1] / partime[1] << endl;
+		if (seq != par || b != c || a != c) {
+			cout << "ERROR : Parallel results don't match" << endl;
+			retval = 1;
+		}
+	}
+
 	cout << endl << "Time spent building the cyclotomic polynomial : "
-		<< gfp::TIME.CYCLOTOMIC << endl;
-#endif
+		<< profile()[PROBE_CYCLOTOMIC].time << endl;
 	cout << endl;
 	cout << "Total duration : " << totaltime << endl;
+	ContextSwitches switches = gfp::contextSwitches();
+	cout << "Context restores : " << switches.restored << " performed, "
+		<< switches.skipped << " skipped" << endl;
 
 	return retval;
 }
@@ -0,0 +1,133 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+/**
+	\example testSubproduct.c++
+	This example illustrates how to use FAAST::SubproductTree to evaluate
+	a polynomial at many points and to interpolate it back.
+*/
+
+#include <faast.hpp>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+using namespace FAAST;
+
+typedef Field<zz_p_Algebra> gfp;
+typedef FieldElement<zz_p_Algebra> gfp_E;
+typedef FieldPolynomial<zz_p_Algebra> gfp_X;
+
+int main(int argv, char* argc[]) {
+	double cputime;
+	int retval = 0;
+
+	long p, d, l, n, t = 4;
+	if (cin.peek() != EOF) {
+	  cin >> p; cin >> d; cin >> l; cin >> n;
+	  if (!(cin >> t)) t = 4;
+	} else {
+	  p = 3; d = 2; l = 3; n = 100;
+	}
+	if (!threadsSupported()) t = 1;
+
+	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	const gfp* K = &(gfp::createField(p,d));
+
+	cout << "\tPoints\tTree\tEval\tHorner\tInterp\tAll (" << t << " threads)" << endl;
+	for (int i = 0 ; i <= l ; i++) {
+		if (i > 0) K = &(K->ArtinSchreierExtension());
+		cout << i << "\t";
+
+		// the points must be distinct, there may not be n of them
+		// in the small fields
+		long m = n;
+		if (K->cardinality() < m) m = to_long(K->cardinality());
+		vector<gfp_E> points;
+		while (long(points.size()) < m) {
+			gfp_E x = K->random();
+			if (find(points.begin(), points.end(), x) == points.end())
+				points.push_back(x);
+		}
+		gfp_X P;
+		for (long j = 0 ; j < m ; j++)
+			P.setCoeff(j, K->random());
+		cout << m << "\t";
+
+		cputime = -GetTime();
+		SubproductTree<zz_p_Algebra> tree(points);
+		cputime += GetTime();
+		cout << cputime << "\t";
+
+		vector<gfp_E> values;
+		cputime = -GetTime();
+		tree.evaluate(P, values);
+		cputime += GetTime();
+		cout << cputime << "\t";
+
+		cputime = -GetTime();
+		for (long j = 0 ; j < m ; j++) {
+			if (P.evaluate(points[j]) != values[j]) {
+				cout << "ERROR : Wrong value at point " << j << endl;
+				retval = 1;
+				break;
+			}
+		}
+		cputime += GetTime();
+		cout << cputime << "\t";
+
+		gfp_X Q;
+		cputime = -GetTime();
+		tree.interpolate(values, Q);
+		cputime += GetTime();
+		cout << cputime << "\t";
+		if (Q != P) {
+			cout << "ERROR : Interpolation does not match" << endl;
+			retval = 1;
+		}
+
+		// again with t threads, splitting down to the smallest nodes
+		// so that the parallel branches are used at any size
+		if (t > 1) {
+			const long grain = getGrainSize();
+			setThreads(t);
+			setGrainSize(1);
+			vector<gfp_E> parvalues;
+			gfp_X R;
+			cputime = -GetWallTime();
+			SubproductTree<zz_p_Algebra> partree(points);
+			partree.evaluate(P, parvalues);
+			partree.interpolate(parvalues, R);
+			cputime += GetWallTime();
+			setGrainSize(grain);
+			setThreads(1);
+			cout << cputime << endl;
+			if (parvalues != values || R != P) {
+				cout << "ERROR : Parallel results don't match" << endl;
+				retval = 1;
+			}
+		} else {
+			cout << "-" << endl;
+		}
+	}
+
+	return retval;
+}
@@ -0,0 +1,163 @@
+/*
+	This file is part of the FAAST library.
+
+	Copyright (c) 2009 Luca De Feo and Éric Schost.
+
+	The most recent version of FAAST is available at http://www.lix.polytechnique.fr/~defeo/FAAST
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; see file COPYING. If not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+/**
+	\example testThreads.c++
+	This example illustrates how to use pushDown() and liftUp()
+	concurrently from several threads.
+*/
+
+#include <faast.hpp>
+#include <cstdlib>
+
+using namespace std;
+using namespace FAAST;
+
+typedef Field<zz_p_Algebra> gfp;
+typedef FieldElement<zz_p_Algebra> gfp_E;
+
+/* The work of one thread : jobs round trips pushDown/liftUp
+ * spread over the levels of the tower.
+ */
+struct Job {
+	const vector<const gfp*>* tower;
+	long jobs;
+	long offset;
+	long errors;
+};
+
+extern "C" void* roundTrips(void* arg) {
+	Job* job = static_cast<Job*>(arg);
+	const vector<const gfp*>& tower = *(job->tower);
+	for (long i = 0 ; i < job->jobs ; i++) {
+		const gfp* K = tower[1 + (i + job->offset) % (tower.size() - 1)];
+		gfp_E a = K->random(), b;
+		vector<gfp_E> down;
+		pushDown(a, down);
+		liftUp(down, b);
+		if (a != b) job->errors++;
+	}
+	return NULL;
+}
+
+/* Copies of the special 0 must not need a modulus : a fresh thread
+ * has none installed.
+ */
+extern "C" void* freshZeros(void* arg) {
+	vector<FieldElement<ZZ_p_Algebra> > v;
+	v.resize(16);
+	long* errors = static_cast<long*>(arg);
+	for (unsigned long i = 0 ; i < v.size() ; i++)
+		if (!v[i].isZero()) (*errors)++;
+	return NULL;
+}
+
+int main(int argv, char* argc[]) {
+	double cputime, walltime, reference = 0;
+	int retval = 0;
+
+	gfp::Infrastructure::BigInt p;
+	long d, l, t;
+	if (cin.peek() != EOF) {
+	  cin >> p; cin >> d; cin >> l; cin >> t;
+	} else {
+	  p = 3; d = 1; l = 4; t = 4;
+	}
+	if (!threadsSupported()) {
+		cout << "NTL is not thread-safe, using only one thread." << endl;
+		t = 1;
+	}
+	const long jobs = 64;
+
+	long zeros = 0;
+	pthread_t fresh;
+	pthread_create(&fresh, NULL, freshZeros, &zeros);
+	pthread_join(fresh, NULL);
+	if (zeros) {
+		cout << "ERROR : copies of the special 0 are not 0" << endl;
+		retval = 1;
+	}
+
+	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	vector<const gfp*> tower;
+	tower.push_back(&(gfp::createField(p,d)));
+	cout << *tower.back() << endl;
+	cputime = -NTL::GetTime();
+	for (long i = 1 ; i <= l ; i++)
+		tower.push_back(&(tower.back()->ArtinSchreierExtension()));
+	cputime += NTL::GetTime();
+	cout << "Height " << l << " in " << cputime << endl;
+
+	// do all the precomputations before starting the threads
+	for (long i = 1 ; i <= l ; i++) {
+		gfp_E a = tower[i]->random(), b;
+		vector<gfp_E> down;
+		pushDown(a, down);
+		liftUp(down, b);
+	}
+
+	cout << endl << "Threads\tJobs\tWall\tJobs/s\tSpeedup" << endl;
+	for (long n = 1 ; n <= t ; n *= 2) {
+		vector<Job> work(n);
+		vector<pthread_t> threads(n);
+		walltime = -GetWallTime();
+		for (long i = 0 ; i < n ; i++) {
+			work[i].tower = &tower;
+			work[i].jobs = jobs;
+			work[i].offset = i;
+			work[i].errors = 0;
+			pthread_create(&threads[i], NULL, roundTrips, &work[i]);
+		}
+		long errors = 0;
+		for (long i = 0 ; i < n ; i++) {
+			pthread_join(threads[i], NULL);
+			errors += work[i].errors;
+		}
+		walltime += GetWallTime();
+
+		double throughput = n * jobs / walltime;
+		if (n == 1) reference = throughput;
+		cout << n << "\t" << n * jobs << "\t" << walltime << "\t"
+			<< throughput << "\t" << throughput / reference << endl;
+		if (errors) {
+			cout << "ERROR : " << errors << " results don't match" << endl;
+			retval = 1;
+		}
+	}
+
+	// the CPU share caps the pool
+	if (t > 1) {
+		setThreads(t);
+		setCPUShare(1.0 / hardwareThreads());
+		if (getThreads() != 1) {
+			cout << "ERROR : the CPU share does not cap the threads" << endl;
+			retval = 1;
+		}
+		setCPUShare(1);
+		if (getThreads() != t) {
+			cout << "ERROR : the CPU share is not released" << endl;
+			retval = 1;
+		}
+		setThreads(1);
+	}
+
+	return retval;
+}
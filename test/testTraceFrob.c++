@@ -36,24 +36,47 @@ typedef FieldElement<zz_p_Algebra> gfp_E;
 
 int main(int argv, char* argc[]) {
 	double cputime;
+	int retval = 0;
 
 	gfp::Infrastructure::BigInt p;
 	long d, l, t;
 	if (cin.peek() != EOF) {
 	  cin >> p; cin >> d; cin >> l; cin >> t;
 	} else {
-	  p = 2; d = 3; l = 4; t = 0;
+	  // d is large enough for the Frobenius tables to be used, and odd
+	  // so that the tower can be built on any defining polynomial
+	  p = 2; d = 101; l = 4; t = 0;
 	}
 
 	cout << "Using " << gfp::Infrastructure::name << endl << endl;
+	setInstrumentation(true);
 	cputime = -NTL::GetTime();
 	const gfp* K = &(gfp::createField(p,d));
 	cputime += NTL::GetTime();
 	cout << *K << " in " << cputime << endl;
-#ifdef FAAST_TIMINGS
 	cout << "Time spent building the irreducible polynomial : "
-		<< gfp::TIME.BUILDIRRED << endl;
-#endif
+		<< profile()[PROBE_BUILDIRRED].time << endl;
+	if (d > 1) {
+		gfp_E a = K->random(), b = a, c, tr = K->zero(), ptr;
+		cputime = -NTL::GetTime();
+		c = a.frobenius(d-1);
+		cputime += NTL::GetTime();
+		for (long i = 0 ; i < d-1 ; i++) {
+			tr += b;
+			b.self_frobenius();
+		}
+		cout << "Frobenius of order " << d-1 << " in the base field : "
+			<< cputime << (b == c ? "" : " (wrong)") << endl;
+		if (b != c) retval = 1;
+		cputime = -NTL::GetTime();
+		ptr = a.pseudotrace(d-1);
+		cputime += NTL::GetTime();
+		cout << "Pseudotrace of order " << d-1 << " in the base field : "
+			<< cputime << (tr == ptr ? "" : " (wrong)") << endl;
+		if (tr != ptr) retval = 1;
+		cout << "Time spent building the Frobenius tables : "
+			<< profile()[PROBE_FROBENIUS].time << endl;
+	}
 	cout << endl;
 
 	cout << "\t\tFrob\tPTr\tPrePTr\tNFrob\tNProj" << endl;
@@ -68,6 +91,7 @@ int main(int argv, char* argc[]) {
 			long n = (j>=i) ?
 				d + RandomBnd(K->d - d) : d*power_long(p, j);
 			double frobtime, pseudotime, naivetime;
+			const Profile before = profile();
 
 			frobtime = -NTL::GetTime();
 			b = a.frobenius(n);
@@ -80,9 +104,8 @@ int main(int argv, char* argc[]) {
 			pseudotime += NTL::GetTime();
 			cout << pseudotime << "\t";
 
-#ifdef FAAST_TIMINGS
-			cout << gfp::TIME.PSEUDOTRACES << "\t";
-#endif
+			cout << profile()[PROBE_PSEUDOTRACES].time
+				- before[PROBE_PSEUDOTRACES].time << "\t";
 
 			naivetime = -NTL::GetTime();
 			for (long i = 0 ; i < 10 ; i++)
@@ -93,5 +116,22 @@ int main(int argv, char* argc[]) {
 				average * n << endl;
 		}
 	}
-	return 0;
+
+	// the norm down to the base field is a power whose base-p digits
+	// are periodic, computed by frobenius
+	if (l >= 1) {
+		gfp_E a = K->random(), b, c = a, conj = a;
+		ZZ pd = power_ZZ(p, d), e = (power(pd, K->d / d) - 1) / (pd - 1);
+		cputime = -NTL::GetTime();
+		b = a ^ e;
+		cputime += NTL::GetTime();
+		for (long i = 1 ; i < K->d / d ; i++) {
+			conj.self_frobenius(d);
+			c *= conj;
+		}
+		cout << endl << "Norm to the base field by exponentiation : "
+			<< cputime << (b == c ? "" : " (wrong)") << endl;
+		if (b != c) retval = 1;
+	}
+	return retval;
 }